@@ -9,6 +9,7 @@
  */
 
 #include "base.h"
+#include "opening.h"
 #include "options.h"
 #include "search.h"
 #include "perft.h"
@@ -503,7 +504,7 @@ int pv_check(const Board *init_board, Line *pv, Search *search)
 	Game game;
 
 	line_to_game(init_board, pv, &game);
-	return game_analyze(&game, search, board_count_empties(init_board), false);
+	return game_analyze(&game, search, board_count_empties(init_board), false, NULL);
 }
 
 /**
@@ -599,46 +600,143 @@ void wthor_test(const char *file, Search *search)
 }
 
 /**
- * @brief Test Eval with a wthor base.
- *
- * Given a wthor file, compare the result of a search to the theoretical scores.
+ * @brief A thread evaluating the games of a wthor base.
+ */
+typedef struct WthorEvalTask {
+	Thread thread;                        /**< thread */
+	Search *search;                       /**< search engine */
+	const WthorBase *base;                /**< wthor base */
+	int depth;                            /**< search depth (-1 to use the level) */
+	int n_positions;                      /**< evaluated positions */
+	unsigned long long n_nodes;           /**< searched nodes */
+	unsigned long long histogram[129][65];/**< histogram of this thread */
+	SpinLock spin;                        /**< lock on the next game */
+	struct WthorEvalTask *master;         /**< owner of the game counter */
+	int next;                             /**< next game to evaluate */
+} WthorEvalTask;
+
+/**
+ * @brief Evaluate the games of a wthor base, one at a time.
  *
- * @param file Game File.
- * @param search Search.
- * @param histogram output array.
+ * @param v Evaluation task.
+ * @return NULL.
  */
-void wthor_eval(const char *file, Search *search, unsigned long long histogram[129][65])
+static void* wthor_eval_task(void *v)
 {
-	WthorBase base;
+	WthorEvalTask *task = (WthorEvalTask*) v;
+	WthorEvalTask *master = task->master;
+	const WthorBase *base = task->base;
+	Search *search = task->search;
 	WthorGame *wthor;
 	Board board;
-	int player;
-	int score;
-	int n_empties;
+	int i, player, score, n_empties;
 
-	if (wthor_load(&base, file)) {
-		foreach_wthorgame(wthor, base) {
-			wthorgame_get_board(wthor, base.header.depth, &board, &player);
-			n_empties = board_count_empties(&board);
-			if (n_empties != base.header.depth && !board_is_game_over(&board)) {
-				continue;
-			}
+	for (;;) {
+		spin_lock(master);
+		i = master->next++;
+		spin_unlock(master);
+		if (i >= base->n_games) break;
+
+		wthor = base->game + i;
+		wthorgame_get_board(wthor, base->header.depth, &board, &player);
+		n_empties = board_count_empties(&board);
+		if (n_empties != base->header.depth && !board_is_game_over(&board)) {
+			continue;
+		}
 
-			if (player == WHITE) score = 64 - 2 * wthor->theoric_score;
-			else score = 2 * wthor->theoric_score - 64;
-			if (abs(score) > 64) {
-				continue;
-			}
+		if (player == WHITE) score = 64 - 2 * wthor->theoric_score;
+		else score = 2 * wthor->theoric_score - 64;
+		if (abs(score) > 64) {
+			continue;
+		}
 
-			search_cleanup(search);
-			search_set_board(search, &board, player);
-			search_set_level(search, options.level, base.header.depth);
-			search_run(search);
-			++histogram[search->result->score + 64][(score + 64) / 2];
+		search_cleanup(search);
+		search_set_board(search, &board, player);
+		if (task->depth < 0) {
+			search_set_level(search, options.level, base->header.depth);
+		} else {
+			search->options.depth = MIN(task->depth, n_empties);
+			search->options.selectivity = NO_SELECTIVITY;
+		}
+		search_run(search);
+		task->n_nodes += search_count_nodes(search);
+		++task->n_positions;
+		++task->histogram[search->result->score + 64][(score + 64) / 2];
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Test Eval with wthor bases.
+ *
+ * Given wthor files, compare the result of a search to the theoretical scores.
+ * The files are loaded one at a time; with several tasks (-n option), the
+ * games of a file are evaluated in parallel, each thread with its own
+ * single-task search and its own histogram, merged at the end.
+ *
+ * @param files Game files, separated by spaces.
+ * @param search Search.
+ * @param depth Search depth, or -1 to search at the current level.
+ * @param histogram output array.
+ */
+void wthor_eval(const char *files, Search *search, const int depth, unsigned long long histogram[129][65])
+{
+	WthorBase base;
+	WthorEvalTask *task;
+	char file[FILENAME_MAX + 1];
+	const int n_task = MAX(options.n_task, 1);
+	int i, j, k, n_positions = 0;
+	unsigned long long n_nodes = 0;
+	long long t = -real_clock();
+
+	task = (WthorEvalTask*) calloc(n_task, sizeof (WthorEvalTask));
+	if (task == NULL) fatal_error("wthor_eval: cannot allocate the tasks\n");
+
+	options.n_task = 1;
+	for (i = 0; i < n_task; ++i) {
+		if (n_task == 1) {
+			task[i].search = search;
+		} else {
+			task[i].search = (Search*) mm_malloc(sizeof (Search));
+			if (task[i].search == NULL) fatal_error("wthor_eval: cannot allocate a search\n");
+			search_init(task[i].search);
+			task[i].search->options.verbosity = 0;
 		}
+		task[i].depth = depth;
+		task[i].base = &base;
+		task[i].master = task;
+	}
+	options.n_task = n_task;
+	if (n_task > 1) search_resize_hashtable(search); // share the memory budget
+	spin_init(task);
+
+	for (files = parse_word(files, file, FILENAME_MAX); *file; files = parse_word(files, file, FILENAME_MAX)) {
+		if (!wthor_load(&base, file)) continue;
+		task->next = 0;
+		for (i = 1; i < n_task; ++i) thread_create(&task[i].thread, wthor_eval_task, task + i);
+		wthor_eval_task(task);
+		for (i = 1; i < n_task; ++i) thread_join(task[i].thread);
 		wthor_free(&base);
 	}
-	return;
+
+	for (i = 0; i < n_task; ++i) {
+		for (j = 0; j < 129; ++j)
+		for (k = 0; k < 65; ++k) histogram[j][k] += task[i].histogram[j][k];
+		n_positions += task[i].n_positions;
+		n_nodes += task[i].n_nodes;
+		if (task[i].search != search) {
+			search_free(task[i].search);
+			mm_free(task[i].search);
+		}
+	}
+	spin_free(task);
+	free(task);
+
+	t += real_clock();
+	printf("%d positions evaluated: %llu nodes in ", n_positions, n_nodes);
+	time_print(t, false, stdout);
+	putchar('\n');
 }
 
 /**
@@ -881,9 +979,89 @@ void base_to_FEN(Base *base, const int n_empties, const char *problem)
 	fclose(f);
 }
 
+/**
+ * @brief Annotate the games of a base with their opening names.
+ *
+ * Each line of the output file holds a game number, its english opening name
+ * and its french opening name, separated by tabulations ("-" when unnamed).
+ *
+ * @param base Game base.
+ * @param file Output filename.
+ */
+void base_to_opening(const Base *base, const char *file)
+{
+	int i;
+	const char *english, *french;
+	FILE *f;
+
+	f = fopen(file, "w");
+	if (f == NULL) {
+		warn("Cannot open file %s\n", file);
+		return;
+	}
+
+	for (i = 0; i < base->n_games; ++i) {
+		opening_get_game_names(base->game + i, &english, &french);
+		fprintf(f, "%d\t%s\t%s\n", i + 1, english ? english : "-", french ? french : "-");
+	}
+
+	fclose(f);
+}
+
+/**
+ * @brief A thread analyzing games of a base.
+ */
+typedef struct BaseAnalyzeTask {
+	Thread thread;                  /**< thread */
+	Search *search;                 /**< search engine */
+	Base *base;                     /**< game base */
+	int *n_error;                   /**< error count of each game (-1 = skipped) */
+	bool *corrected;                /**< correction status of each game */
+	int n_empties;                  /**< number of empties */
+	bool apply_correction;          /**< correct bad moves */
+	unsigned long long n_nodes;     /**< searched nodes */
+	SpinLock spin;                  /**< lock on the next game */
+	struct BaseAnalyzeTask *master; /**< owner of the game counter */
+	int next;                       /**< next game to analyze */
+} BaseAnalyzeTask;
+
+/**
+ * @brief Analyze the games of a base, one at a time.
+ *
+ * @param v Analysis task.
+ * @return NULL.
+ */
+static void* base_analyze_task(void *v)
+{
+	BaseAnalyzeTask *task = (BaseAnalyzeTask*) v;
+	BaseAnalyzeTask *master = task->master;
+	Game *game;
+	int i;
+
+	for (;;) {
+		spin_lock(master);
+		i = master->next++;
+		spin_unlock(master);
+		if (i >= task->base->n_games) break;
+
+		game = task->base->game + i;
+		task->n_error[i] = -1;
+		if (game_score(game) == 0) continue;
+		task->n_error[i] = game_analyze(game, task->search, task->n_empties, task->apply_correction, &task->n_nodes);
+		if (task->n_error[i] && task->apply_correction) {
+			task->corrected[i] = !game_analyze(game, task->search, task->n_empties, false, &task->n_nodes);
+		}
+	}
+
+	return NULL;
+}
+
 /**
  * @brief Base analysis.
  *
+ * With several tasks (-n option), the games are analyzed in parallel, each
+ * thread with its own single-task search, and reported in the base order.
+ *
  * @param base Game base.
  * @param search Search engine.
  * @param n_empties Number of empties.
@@ -893,20 +1071,80 @@ void base_analyze(Base *base, Search *search, const int n_empties, const bool ap
 {
 	int i;
 	int n_error;
-
-	for (i = 0; i < base->n_games; ++i) {
-		if (game_score(base->game + i) == 0) continue;
-		game_export_text(base->game + i, stdout);
-		n_error = game_analyze(base->game + i, search, n_empties, apply_correction);
-		if (n_error) {
-			printf("Game #%d contains %d errors", i, n_error);
-			if (apply_correction) {
-				if (game_analyze(base->game + i, search, n_empties, false)) printf("... correction failed! ***BUG DETECTED!***\n");
-				else printf("... corrected!\n");
-			} else putchar('\n');
-		}
-		printf("%d/%d %.1f %% done.\r", i + 1, base->n_games, 100.0 * (i + 1) / base->n_games); fflush(stdout);
+	unsigned long long n_nodes = 0;
+	long long t = -real_clock();
+
+	if (options.n_task > 1 && base->n_games > 1) {
+		const int n_task = options.n_task;
+		BaseAnalyzeTask *task = (BaseAnalyzeTask*) malloc(n_task * sizeof (BaseAnalyzeTask));
+		int *error = (int*) malloc(base->n_games * sizeof (int));
+		bool *corrected = (bool*) calloc(base->n_games, sizeof (bool));
+
+		if (task == NULL || error == NULL || corrected == NULL) fatal_error("base_analyze: cannot allocate the tasks\n");
+
+		options.n_task = 1;
+		for (i = 0; i < n_task; ++i) {
+			task[i].search = (Search*) mm_malloc(sizeof (Search));
+			if (task[i].search == NULL) fatal_error("base_analyze: cannot allocate a search\n");
+			search_init(task[i].search);
+			task[i].base = base;
+			task[i].n_error = error;
+			task[i].corrected = corrected;
+			task[i].n_empties = n_empties;
+			task[i].apply_correction = apply_correction;
+			task[i].n_nodes = 0;
+			task[i].master = task;
+		}
+		options.n_task = n_task;
+		search_resize_hashtable(search); // share the memory budget
+		spin_init(task);
+		task->next = 0;
+
+		for (i = 1; i < n_task; ++i) thread_create(&task[i].thread, base_analyze_task, task + i);
+		base_analyze_task(task);
+		for (i = 1; i < n_task; ++i) thread_join(task[i].thread);
+
+		for (i = 0; i < n_task; ++i) {
+			n_nodes += task[i].n_nodes;
+			search_free(task[i].search);
+			mm_free(task[i].search);
+		}
+		spin_free(task);
+
+		for (i = 0; i < base->n_games; ++i) {
+			if (error[i] < 0) continue;
+			game_export_text(base->game + i, stdout);
+			if (error[i]) {
+				printf("Game #%d contains %d errors", i, error[i]);
+				if (apply_correction) {
+					if (!corrected[i]) printf("... correction failed! ***BUG DETECTED!***\n");
+					else printf("... corrected!\n");
+				} else putchar('\n');
+			}
+		}
+		free(task);
+		free(error);
+		free(corrected);
+	} else {
+		for (i = 0; i < base->n_games; ++i) {
+			if (game_score(base->game + i) == 0) continue;
+			game_export_text(base->game + i, stdout);
+			n_error = game_analyze(base->game + i, search, n_empties, apply_correction, &n_nodes);
+			if (n_error) {
+				printf("Game #%d contains %d errors", i, n_error);
+				if (apply_correction) {
+					if (game_analyze(base->game + i, search, n_empties, false, &n_nodes)) printf("... correction failed! ***BUG DETECTED!***\n");
+					else printf("... corrected!\n");
+				} else putchar('\n');
+			}
+			printf("%d/%d %.1f %% done.\r", i + 1, base->n_games, 100.0 * (i + 1) / base->n_games); fflush(stdout);
+		}
 	}
+
+	t += real_clock();
+	printf("%d games analyzed: %llu nodes in ", base->n_games, n_nodes);
+	time_print(t, false, stdout);
+	putchar('\n');
 }
 
 /**
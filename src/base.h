@@ -56,7 +56,7 @@ void wthor_init(WthorBase*);
 bool wthor_load(WthorBase*, const char*);
 bool wthor_save(WthorBase*, const char*);
 void wthor_test(const char*, struct Search*);
-void wthor_eval(const char*, struct Search*, unsigned long long histogram[129][65]);
+void wthor_eval(const char*, struct Search*, const int, unsigned long long histogram[129][65]);
 void wthor_edaxify(const char*);
 
 #define foreach_wthorgame(wgame, wbase) \
@@ -69,6 +69,7 @@ void base_save(const Base*, const char*);
 void base_append(Base*, const Game*);
 void base_to_problem(Base*, const int, const char*);
 void base_to_FEN(Base*, const int, const char*);
+void base_to_opening(const Base*, const char*);
 void base_analyze(Base*, struct Search*, const int, const bool);
 void base_complete(Base*, struct Search*);
 void base_unique(Base*);
@@ -8,6 +8,7 @@
 
 #include "bit.h"
 #include "board.h"
+#include "eval.h"
 #include "move.h"
 #include "options.h"
 #include "search.h"
@@ -41,6 +42,31 @@ static unsigned long long click(void)
 #endif
 }
 
+/** performance counters of the benchmarks */
+static PerfCounters bench_perf;
+
+/*
+ * @brief Start the performance counters of a benchmark.
+ */
+static void bench_perf_start(void)
+{
+	if (options.perf_counters) perf_counters_start(&bench_perf);
+}
+
+/*
+ * @brief Stop & print the performance counters of a benchmark per call.
+ *
+ * @param name Benchmark name.
+ * @param n_calls Number of calls.
+ */
+static void bench_perf_print(const char *name, const double n_calls)
+{
+	if (options.perf_counters) {
+		perf_counters_stop(&bench_perf);
+		perf_counters_print(&bench_perf, name, n_calls, "call", stdout);
+	}
+}
+
 /*
  * @brief Move generator performance test.
  */
@@ -74,6 +100,7 @@ static void bench_move_generator(void)
 	t_mean = t_var = 0.0;
 	t_max = 0;
 	t_min = 1e30;
+	bench_perf_start();
 
 	for (x = A1; x < PASS; ++x) {
 		board_set(&board, b);
@@ -106,6 +133,7 @@ static void bench_move_generator(void)
 	t_var = t_var / x - (t_mean * t_mean);
 
 	printf("board_get_move_flip:  %.2f < %.2f +/- %.2f < %.2f\n", t_min, t_mean, sqrt(t_var), t_max);
+	bench_perf_print("board_get_move_flip", x * (double) (N_WARMUP + N_REPEAT));
 }
 
 /*
@@ -141,6 +169,7 @@ static void bench_count_last_flip(void)
 	t_mean = t_var = 0.0;
 	t_max = 0;
 	t_min = 1e30;
+	bench_perf_start();
 
 	for (x = A1; x < PASS; ++x) {
 		board_set(&board, b);
@@ -173,6 +202,7 @@ static void bench_count_last_flip(void)
 	t_var = t_var / x - (t_mean * t_mean);
 
 	printf("count_last_flip:  %.2f < %.2f +/- %.2f < %.2f\n", t_min, t_mean, sqrt(t_var), t_max);
+	bench_perf_print("count_last_flip", x * (double) (N_WARMUP + N_REPEAT));
 }
 
 /*
@@ -209,6 +239,7 @@ static void bench_board_score_1(void)
 	t_mean = t_var = 0.0;
 	t_max = 0;
 	t_min = 1e30;
+	bench_perf_start();
 
 	for (x = A1; x < PASS; ++x) {
 		board_set(&board, b);
@@ -241,6 +272,7 @@ static void bench_board_score_1(void)
 	t_var = t_var / x - (t_mean * t_mean);
 
 	printf("board_score_1:  %.2f < %.2f +/- %.2f < %.2f\n", t_min, t_mean, sqrt(t_var), t_max);
+	bench_perf_print("board_score_1", x * (double) (N_WARMUP + N_REPEAT));
 }
 
 /*
@@ -281,6 +313,7 @@ static void bench_mobility(void)
 	t_mean = t_var = 0.0;
 	t_max = 0;
 	t_min = 1e30;
+	bench_perf_start();
 
 	for (x = A1; x < PASS; ++x) {
 		board_set(&board, b);
@@ -319,6 +352,7 @@ static void bench_mobility(void)
 	t_var = t_var / x - (t_mean * t_mean);
 
 	printf("mobility:  %.2f < %.2f +/- %.2f < %.2f\n", t_min, t_mean, sqrt(t_var), t_max);
+	bench_perf_print("mobility", x * (double) (N_WARMUP + N_REPEAT));
 }
 
 /*
@@ -359,6 +393,7 @@ static void bench_stability(void)
 	t_mean = t_var = 0.0;
 	t_max = 0;
 	t_min = 1e30;
+	bench_perf_start();
 
 	for (x = A1; x < PASS; ++x) {
 		board_set(&board, b);
@@ -395,6 +430,153 @@ static void bench_stability(void)
 	t_var = t_var / x - (t_mean * t_mean);
 	
 	printf("stability:  %.2f < %.2f +/- %.2f < %.2f\n", t_min, t_mean, sqrt(t_var), t_max);
+	bench_perf_print("stability", x * (double) (N_WARMUP + N_REPEAT));
+}
+
+/*
+ * @brief Unique board performance test.
+ */
+static void bench_board_unique(void)
+{
+	Board board[64], unique;
+	Random r;
+	int i, x;
+	volatile int v;
+	const int N_WARMUP = 1000;
+	const int N_REPEAT = 1000000;
+	unsigned long long c, overhead;
+	long long t_real;
+	double t, t_mean, t_var, t_min, t_max;
+
+	random_seed(&r, 0x5e7);
+	for (x = 0; x < 64; ++x) board_rand(board + x, x % 50, &r);
+
+	v = 0;
+	c = -click();
+	for (i = 0; i < N_WARMUP; ++i) {
+		v += (int) board[i & 63].player;
+	}
+	c += click();
+
+	c = -click();
+	for (i = 0; i < N_REPEAT; ++i) {
+		v += (int) board[i & 63].player;
+	}
+	c += click();
+	overhead = c;
+
+	t_mean = t_var = 0.0;
+	t_max = 0;
+	t_min = 1e30;
+	bench_perf_start();
+	t_real = -real_clock();
+
+	for (x = 0; x < 64; ++x) {
+		c = -click();
+		for (i = 0; i < N_WARMUP; ++i) {
+			v += board_unique(board + ((i + x) & 63), &unique);
+		}
+		c += click();
+
+		c = -click();
+		for (i = 0; i < N_REPEAT; ++i) {
+			v += board_unique(board + ((i + x) & 63), &unique);
+		}
+		c += click();
+
+		t = ((double)(c - overhead)) / N_REPEAT;
+		t_mean += t;
+		t_var += t * t;
+		if (t < t_min) t_min = t;
+		if (t > t_max) t_max = t;
+
+		if (options.verbosity >= 2) printf("v = %d\n", v);
+	}
+	t_real += real_clock();
+
+	t_mean /= x;
+	t_var = t_var / x - (t_mean * t_mean);
+
+	printf("board_unique:  %.2f < %.2f +/- %.2f < %.2f", t_min, t_mean, sqrt(t_var), t_max);
+	if (t_real > 0) printf(" (%.1f M calls/s)", 0.001 * x * (N_WARMUP + N_REPEAT) / t_real);
+	putchar('\n');
+	bench_perf_print("board_unique", x * (double) (N_WARMUP + N_REPEAT));
+}
+
+/*
+ * @brief Evaluation setup performance test.
+ */
+static void bench_eval_set(void)
+{
+	Board board[64];
+	Eval eval[64];
+	Random r;
+	int i, x;
+	volatile int v;
+	const int N_WARMUP = 1000;
+	const int N_REPEAT = 1000000;
+	unsigned long long c, overhead;
+	long long t_real;
+	double t, t_mean, t_var, t_min, t_max;
+
+	random_seed(&r, 0xe5e7);
+	for (x = 0; x < 64; ++x) {
+		board_rand(board + x, x % 60, &r);
+		eval[x].n_empties = board_count_empties(board + x);
+	}
+
+	v = 0;
+	c = -click();
+	for (i = 0; i < N_WARMUP; ++i) {
+		v += (int) board[i & 63].player;
+	}
+	c += click();
+
+	c = -click();
+	for (i = 0; i < N_REPEAT; ++i) {
+		v += (int) board[i & 63].player;
+	}
+	c += click();
+	overhead = c;
+
+	t_mean = t_var = 0.0;
+	t_max = 0;
+	t_min = 1e30;
+	bench_perf_start();
+	t_real = -real_clock();
+
+	for (x = 0; x < 64; ++x) {
+		c = -click();
+		for (i = 0; i < N_WARMUP; ++i) {
+			eval_set(eval + x, board + ((i + x) & 63));
+			v += eval[x].feature.us[0];
+		}
+		c += click();
+
+		c = -click();
+		for (i = 0; i < N_REPEAT; ++i) {
+			eval_set(eval + x, board + ((i + x) & 63));
+			v += eval[x].feature.us[0];
+		}
+		c += click();
+
+		t = ((double)(c - overhead)) / N_REPEAT;
+		t_mean += t;
+		t_var += t * t;
+		if (t < t_min) t_min = t;
+		if (t > t_max) t_max = t;
+
+		if (options.verbosity >= 2) printf("v = %d\n", v);
+	}
+	t_real += real_clock();
+
+	t_mean /= x;
+	t_var = t_var / x - (t_mean * t_mean);
+
+	printf("eval_set:  %.2f < %.2f +/- %.2f < %.2f", t_min, t_mean, sqrt(t_var), t_max);
+	if (t_real > 0) printf(" (%.1f M calls/s)", 0.001 * x * (N_WARMUP + N_REPEAT) / t_real);
+	putchar('\n');
+	bench_perf_print("eval_set", x * (double) (N_WARMUP + N_REPEAT));
 }
 
 /**
@@ -403,11 +585,15 @@ static void bench_stability(void)
 void bench(void)
 {
 	printf("The unit of the results is CPU cycles\n");
+	if (options.perf_counters && perf_counters_open(&bench_perf) == 0) warn("No hardware performance counter available\n");
 	bench_move_generator();
 	bench_count_last_flip();
 	bench_board_score_1();
 	bench_mobility();
 	bench_stability();
+	bench_board_unique();
+	bench_eval_set();
+	if (options.perf_counters) perf_counters_close(&bench_perf);
 }
 
 
@@ -25,11 +25,14 @@
 #include "util.h"
 
 #include <ctype.h>
+#include <string.h>
 #include <stdlib.h>
 #include <assert.h>
 
 
-#if MOVE_GENERATOR == MOVE_GENERATOR_CARRY
+#if defined(FLIP_SOURCE)	// alternative kernel with the interface of MOVE_GENERATOR (see harness.c)
+	#include FLIP_SOURCE
+#elif MOVE_GENERATOR == MOVE_GENERATOR_CARRY
 	#include "flip_carry_64.c"
 #elif MOVE_GENERATOR == MOVE_GENERATOR_SSE
 	#include "flip_sse.c"
@@ -61,8 +64,8 @@
 #endif
 
 
-/** edge stability global data */
-unsigned char edge_stability[256 * 256];
+/* edge stability global data, generated by "make tables" */
+#include "edge_stability.h"
 
 #if (defined(USE_GAS_MMX) || defined(USE_MSVC_X86)) && !defined(hasSSE2)
 	#include "board_mmx.c"
@@ -286,7 +289,9 @@ void board_symetry(const Board *board, const int s, Board *sym)
  *
  * @param board input board
  * @param unique output board
+ * @return the symetry from board to unique.
  */
+#ifndef __AVX2__	// AVX2 version in board_sse.c
 int board_unique(const Board *board, Board *unique)
 {
 	Board sym[8];
@@ -314,6 +319,7 @@ int board_unique(const Board *board, Board *unique)
 	board_check(unique);
 	return s;
 }
+#endif
 
 /** 
  * @brief Get a random board by playing random moves.
@@ -742,27 +748,48 @@ static int find_edge_stable(const int old_P, const int old_O, int stable)
 }
 
 /**
- * @brief Initialize the edge stability table.
+ * @brief Compute the edge stability table.
+ *
+ * The table is shipped precomputed in edge_stability.h; this is the code that
+ * generates it (see tables.c) and checks it in debug builds.
+ *
+ * @param table edge stability table to fill (256 * 256 entries).
  */
-void edge_stability_init(void)
+void edge_stability_generate(unsigned char *table)
 {
 	int P, O, PO, rPO;
-	// long long t = cpu_clock();
 
 	for (PO = 0; PO < 256 * 256; ++PO) {
 		P = PO >> 8;
 		O = PO & 0xFF;
 		if (P & O) { // illegal positions
-			edge_stability[PO] = 0;
+			table[PO] = 0;
 		} else {
 			rPO = horizontal_mirror_32(PO);
 			if (PO > rPO)
-				edge_stability[PO] = mirror_byte(edge_stability[rPO]);
+				table[PO] = mirror_byte(table[rPO]);
 			else
-				edge_stability[PO] = find_edge_stable(P, O, P);
+				table[PO] = find_edge_stable(P, O, P);
 		}
 	}
-	// printf("edge_stability_init: %d\n", (int)(cpu_clock() - t));
+}
+
+/**
+ * @brief Initialize the edge stability table.
+ *
+ * Nothing to do, as the table is constant data. Debug builds regenerate it
+ * and check it against the precomputed one.
+ */
+void edge_stability_init(void)
+{
+#ifndef NDEBUG
+	unsigned char *table = (unsigned char*) malloc(256 * 256);
+
+	if (table == NULL) fatal_error("Cannot allocate the edge stability table.\n");
+	edge_stability_generate(table);
+	if (memcmp(table, edge_stability, 256 * 256) != 0) fatal_error("edge_stability.h is out of date: run \"make tables\".\n");
+	free(table);
+#endif
 }
 
 #ifdef HAS_CPU_64
@@ -1105,6 +1132,36 @@ int board_count_empties(const Board *board)
 	return bit_count(~(board->player | board->opponent));
 }
 
+/**
+ * @brief Get the empty squares lying in odd regions.
+ *
+ * A region is a set of 8-connected empty squares. Each region is grown
+ * from its first square by bitboard dilation, masked with the empties.
+ *
+ * @param E bitboard with empty squares.
+ * @param single returned bitboard with isolated (single square region) empties.
+ * @return empty squares belonging to a region of odd size.
+ */
+unsigned long long get_odd_regions(unsigned long long E, unsigned long long *single)
+{
+	unsigned long long odd = 0, one = 0, seed, region, prev;
+
+	while (E) {
+		region = seed = E & -E;
+		do {
+			prev = region;
+			region |= ((region >> 1) & 0x7F7F7F7F7F7F7F7F) | ((region << 1) & 0xFEFEFEFEFEFEFEFE);
+			region = (region | (region >> 8) | (region << 8)) & E;
+		} while (region != prev);
+		if (region == seed) one |= seed;
+		if (bit_count(region) & 1) odd |= region;
+		E ^= region;
+	}
+
+	*single = one;
+	return odd;
+}
+
 /**
  * @brief Print out the board.
  *
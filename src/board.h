@@ -56,6 +56,7 @@ char* board_to_FEN(const Board*, const int, char*);
 bool board_is_pass(const Board*);
 bool board_is_game_over(const Board*);
 int board_count_empties(const Board *board);
+unsigned long long get_odd_regions(unsigned long long, unsigned long long*);
 
 bool can_move(const unsigned long long, const unsigned long long);
 unsigned long long get_moves_6x6(const unsigned long long, const unsigned long long);
@@ -67,6 +68,7 @@ int get_mobility(const unsigned long long, const unsigned long long);
 	unsigned long long get_potential_moves(const unsigned long long, const unsigned long long);
 #endif
 
+void edge_stability_generate(unsigned char*);
 void edge_stability_init(void);
 unsigned long long get_stable_edge(const unsigned long long, const unsigned long long);
 int get_stability(const unsigned long long, const unsigned long long);
@@ -85,7 +87,7 @@ int get_corner_stability(const unsigned long long);
 	int get_stability_sse(const unsigned long long P, const unsigned long long O);
 #endif
 
-extern unsigned char edge_stability[256 * 256];
+extern const unsigned char edge_stability[256 * 256];
 
 // a1/a8/h1/h8 are already stable in horizontal line, so omit them in vertical line to ease kindergarten for CPU_64
 #if 0 // defined(__BMI2__) && defined(HAS_CPU_64) && !defined(__bdver4__) && !defined(__znver1__) && !defined(__znver2__) // pdep is slow on AMD before Zen3
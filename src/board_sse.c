@@ -184,6 +184,98 @@ void board_symetry(const Board *board, const int s, Board *sym)
 
 #endif // hasSSE2/Neon
 
+/**
+ * @brief AVX2 translation of board_unique
+ *
+ * The 8 symetries are computed two by two, a board per 128-bit lane, and the
+ * least one is selected by a tournament. As in board.c, the first of equal
+ * boards, in the symetry order, is selected.
+ *
+ * @param board input board
+ * @param unique output board
+ * @return the symetry from board to unique.
+ */
+#ifdef __AVX2__
+
+static __m256i vectorcall board_horizontal_mirror_avx2(__m256i bb)
+{
+	const __m256i mask0F0F = _mm256_set1_epi16(0x0F0F);
+	const __m256i mbitrev  = _mm256_set_epi8(15, 7, 11, 3, 13, 5, 9, 1, 14, 6, 10, 2, 12, 4, 8, 0,
+		15, 7, 11, 3, 13, 5, 9, 1, 14, 6, 10, 2, 12, 4, 8, 0);
+	return _mm256_or_si256(_mm256_shuffle_epi8(mbitrev, _mm256_and_si256(_mm256_srli_epi64(bb, 4), mask0F0F)),
+		_mm256_slli_epi64(_mm256_shuffle_epi8(mbitrev, _mm256_and_si256(bb, mask0F0F)), 4));
+}
+
+static __m256i vectorcall board_vertical_mirror_avx2(__m256i bb)
+{
+	return _mm256_shuffle_epi8(bb, _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+		8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+static __m256i vectorcall board_transpose_avx2(__m256i bb)
+{
+	const __m256i mask00AA = _mm256_set1_epi16(0x00AA);
+	const __m256i maskCCCC = _mm256_set1_epi32(0x0000CCCC);
+	const __m256i mask00F0 = _mm256_set1_epi64x(0x00000000F0F0F0F0);
+	__m256i tt = _mm256_and_si256(_mm256_xor_si256(bb, _mm256_srli_epi64(bb, 7)), mask00AA);
+	bb = _mm256_xor_si256(_mm256_xor_si256(bb, tt), _mm256_slli_epi64(tt, 7));
+	tt = _mm256_and_si256(_mm256_xor_si256(bb, _mm256_srli_epi64(bb, 14)), maskCCCC);
+	bb = _mm256_xor_si256(_mm256_xor_si256(bb, tt), _mm256_slli_epi64(tt, 14));
+	tt = _mm256_and_si256(_mm256_xor_si256(bb, _mm256_srli_epi64(bb, 28)), mask00F0);
+	bb = _mm256_xor_si256(_mm256_xor_si256(bb, tt), _mm256_slli_epi64(tt, 28));
+	return bb;
+}
+
+/* mask of the lanes where the board of b1 is lesser than the board of b2 */
+static __m256i vectorcall board_lesser_avx2(__m256i b1, __m256i b2)
+{
+	const __m256i sign = _mm256_set1_epi64x(0x8000000000000000);
+	__m256i lt = _mm256_cmpgt_epi64(_mm256_xor_si256(b2, sign), _mm256_xor_si256(b1, sign));
+	__m256i eq = _mm256_cmpeq_epi64(b1, b2);
+	lt = _mm256_or_si256(lt, _mm256_and_si256(eq, _mm256_unpackhi_epi64(lt, lt)));	// player, then opponent
+	return _mm256_unpacklo_epi64(lt, lt);
+}
+
+int board_unique(const Board *board, Board *unique)
+{
+	__m256i	bb, s01, s23, s45, s67, i01, i23, i45, i67, lt;
+	__m128i	s0, s1, i0, i1, m;
+
+	assert(board != unique);
+
+	bb = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i *) board));
+	s01 = _mm256_blend_epi32(bb, board_horizontal_mirror_avx2(bb), 0xf0);	// 0, h
+	s23 = board_vertical_mirror_avx2(s01);	// v, vh
+	s45 = board_transpose_avx2(s01);	// t, th = vt
+	s67 = board_transpose_avx2(s23);	// tv = ht, tvh = vht
+	i01 = _mm256_set_epi64x(1, 1, 0, 0);
+	i23 = _mm256_set_epi64x(3, 3, 2, 2);
+	i45 = _mm256_set_epi64x(5, 5, 4, 4);
+	i67 = _mm256_set_epi64x(7, 7, 6, 6);
+
+	lt = board_lesser_avx2(s23, s01);
+	s01 = _mm256_blendv_epi8(s01, s23, lt);
+	i01 = _mm256_blendv_epi8(i01, i23, lt);
+	lt = board_lesser_avx2(s67, s45);
+	s45 = _mm256_blendv_epi8(s45, s67, lt);
+	i45 = _mm256_blendv_epi8(i45, i67, lt);
+	lt = board_lesser_avx2(s45, s01);
+	s01 = _mm256_blendv_epi8(s01, s45, lt);
+	i01 = _mm256_blendv_epi8(i01, i45, lt);
+
+	s0 = _mm256_castsi256_si128(s01);	s1 = _mm256_extracti128_si256(s01, 1);
+	i0 = _mm256_castsi256_si128(i01);	i1 = _mm256_extracti128_si256(i01, 1);
+	lt = board_lesser_avx2(_mm256_castsi128_si256(s1), _mm256_castsi128_si256(s0));
+	m = _mm_cmpeq_epi64(s0, s1);
+	m = _mm_or_si128(_mm256_castsi256_si128(lt), _mm_and_si128(_mm_and_si128(m, _mm_unpackhi_epi64(m, m)), _mm_cmpgt_epi64(i0, i1)));	// first of equal boards
+	_mm_storeu_si128((__m128i *) unique, _mm_blendv_epi8(s0, s1, m));
+
+	board_check(unique);
+	return _mm_cvtsi128_si32(_mm_blendv_epi8(i0, i1, m));
+}
+
+#endif // __AVX2__
+
 /**
  * @brief Compute a board resulting of a move played on a previous board.
  *
@@ -497,17 +497,19 @@ static int position_get_moves(const Position *position, const Board *board, Move
 				x = symetry(position->link[i].move, s);
 				board_get_move_flip(board, x, move);
 				move->score = position->link[i].score;
-				previous = previous->next = move;
+				move_set_next(previous, move);
+				previous = move;
 				++move;
 			}
 			x = symetry(position->leaf.move, s);
 			if (x != NOMOVE) {
 				board_get_move_flip(board, x, move);
 				move->score = position->leaf.score;
-				previous = previous->next = move;
+				move_set_next(previous, move);
+				previous = move;
 				++move;
 			}
-			previous->next = NULL;
+			previous->next = 0;
 			movelist->n_moves = move - movelist->move - 1;
 			movelist_sort(movelist);
 			return s;
@@ -801,6 +803,85 @@ static void position_expand(Position *position, Book *book)
 	}
 }
 
+/**
+ * @brief Negamax the leaf of a position.
+ *
+ * Reset the position scores & game statistics to the ones of its best
+ * remaining (unlinked) move.
+ *
+ * @param position Position.
+ * @param book Opening book.
+ * @param stat Game statistics.
+ */
+static void position_negamax_leaf(Position *position, const Book *book, GameStats *stat)
+{
+	const int n_empties = board_count_empties(&position->board);
+	const int search_depth = LEVEL[position->level][n_empties].depth;
+	const int bias = (search_depth & 1) - (n_empties & 1);
+
+	position->score.value = position->score.lower = position->score.upper = -SCORE_INF;
+
+	if (position->leaf.score > -SCORE_INF) {
+		position->score.value = position->leaf.score;
+		// is solving
+		if (search_depth == n_empties && LEVEL[position->level][n_empties].selectivity == NO_SELECTIVITY) {
+			position->score.lower = position->score.upper = position->score.value;
+			if (position->leaf.score > 0) ++stat->n_wins;
+			else if (position->leaf.score < 0) ++stat->n_losses;
+			else ++stat->n_draws;
+		// is pre-solving
+		} else if (search_depth == n_empties) {
+			position->score.lower = position->score.value - book->options.endcut_error;
+			position->score.upper = position->score.value + book->options.endcut_error;
+		} else { // midgame
+			position->score.lower = position->score.value - book->options.midgame_error - bias;
+			position->score.upper = position->score.value + book->options.midgame_error - bias;
+		}
+		++stat->n_lines;
+	}
+}
+
+/**
+ * @brief Negamax a link of a position.
+ *
+ * Update the link score, the position scores & game statistics from an
+ * already negamaxed child position.
+ *
+ * @param position Position.
+ * @param l Link to the child position.
+ * @param child Child position.
+ * @param book Opening book.
+ * @param stat Game statistics.
+ */
+static void position_negamax_link(Position *position, Link *l, const Position *child, Book *book, GameStats *stat)
+{
+	if (l->score != -child->score.value) {
+		l->score = -child->score.value;
+		book->need_saving = true;
+	}
+	if (l->score > position->score.value) position->score.value = l->score;
+	if (-child->score.upper > position->score.lower) position->score.lower = -child->score.upper;
+	if (-child->score.lower > position->score.upper) position->score.upper = -child->score.lower;
+	stat->n_wins += child->n_losses;
+	stat->n_draws += child->n_draws;
+	stat->n_losses += child->n_wins;
+	stat->n_lines += child->n_lines;
+}
+
+/**
+ * @brief Set the game statistics of a position.
+ *
+ * @param position Position.
+ * @param stat Game statistics.
+ */
+static void position_set_stats(Position *position, const GameStats *stat)
+{
+	position->n_wins = (unsigned int) MIN(UINT_MAX, stat->n_wins);
+	position->n_draws = (unsigned int) MIN(UINT_MAX, stat->n_draws);
+	position->n_losses = (unsigned int) MIN(UINT_MAX, stat->n_losses);
+	position->n_lines = (unsigned int) MIN(UINT_MAX, stat->n_lines);
+}
+
 /**
  * @brief Negamax a position.
  *
@@ -817,55 +898,19 @@ static int position_negamax(Position *position, Book *book)
 
 	if (!position->done) {
 		GameStats stat = {0,0,0,0};
-		const int n_empties = board_count_empties(&position->board);
-		const int search_depth = LEVEL[position->level][n_empties].depth;
-		const int bias = (search_depth & 1) - (n_empties & 1);
 
 		position->done = 1;
 
-		position->score.value = position->score.lower = position->score.upper = -SCORE_INF;
-
-		if (position->leaf.score > -SCORE_INF) {
-			position->score.value = position->leaf.score;
-			// is solving
-			if (search_depth == n_empties && LEVEL[position->level][n_empties].selectivity == NO_SELECTIVITY) {
-				position->score.lower = position->score.upper = position->score.value;
-				if (position->leaf.score > 0) ++stat.n_wins;
-				else if (position->leaf.score < 0) ++stat.n_losses;
-				else ++stat.n_draws;
-			// is pre-solving
-			} else if (search_depth == n_empties) {
-				position->score.lower = position->score.value - book->options.endcut_error;
-				position->score.upper = position->score.value + book->options.endcut_error;
-			} else { // midgame
-				position->score.lower = position->score.value - book->options.midgame_error - bias;
-				position->score.upper = position->score.value + book->options.midgame_error - bias;
-			}
-			++stat.n_lines;
-		}
+		position_negamax_leaf(position, book, &stat);
 
 		foreach_link(l, position) {
 			board_next(&position->board, l->move, &target);
 			child = book_probe(book, &target);
 			position_negamax(child, book);
-			if (l->score != -child->score.value) {
-				l->score = -child->score.value;
-				book->need_saving = true;
-			}
-			if (l->score > position->score.value) position->score.value = l->score;
-			if (-child->score.upper > position->score.lower) position->score.lower = -child->score.upper;
-			if (-child->score.lower > position->score.upper) position->score.upper = -child->score.lower;
-
-			stat.n_wins += child->n_losses;
-			stat.n_draws += child->n_draws;
-			stat.n_losses += child->n_wins;
-			stat.n_lines += child->n_lines;
+			position_negamax_link(position, l, child, book, &stat);
 		}
 
-		position->n_wins = (unsigned int) MIN(UINT_MAX, stat.n_wins);
-		position->n_draws = (unsigned int) MIN(UINT_MAX, stat.n_draws);
-		position->n_losses = (unsigned int) MIN(UINT_MAX, stat.n_losses);
-		position->n_lines = (unsigned int) MIN(UINT_MAX, stat.n_lines);
+		position_set_stats(position, &stat);
 	}
 
 	return position->score.value;
@@ -1027,48 +1072,6 @@ static void position_enhance(Position *position, Book *book)
 	}
 }
 
-/**
- * @brief Feed hash from a position.
- *
- * Go through the book sub-tree following the current position & feed the hash table from this position.
- *
- * @param board Position to expand.
- * @param book Opening book.
- * @param search Hashtables container.
- * @param is_pv Flag to tell if the position is from the principal variation.
- */
-static void board_feed_hash(Board *board, const Book *book, Search *search, const bool is_pv)
-{
-	Position *position;
-	const unsigned long long hash_code = board_get_hash_code(board);
-	MoveList movelist;
-	Move *m;
-	HashStoreData hash_data;
-
-	position = book_probe(book, board);
-	if (position) {
-		const int n_empties = board_count_empties(&position->board);
-		const int score = position->score.value;
-		int move = NOMOVE;
-
-		hash_data.data.wl.c.depth = LEVEL[position->level][n_empties].depth;
-		hash_data.data.wl.c.selectivity = LEVEL[position->level][n_empties].selectivity;
-
-		position_get_moves(position, board, &movelist);
-		foreach_move(m, movelist) {
-			if (move == NOMOVE) move = m->x;
-			board_update(board, m);
-				board_feed_hash(board, book, search, is_pv && m->score == score);
-			board_restore(board, m);
-		}
-
-		hash_data.data.lower = hash_data.data.upper = score;
-		hash_data.data.move[0] = move;
-		hash_feed(&search->hash_table, board, hash_code, &hash_data);
-		if (is_pv) hash_feed(&search->pv_table, board, hash_code, &hash_data);
-	}
-}
-
 /**
  * @brief Fill the opening book.
  *
@@ -1302,6 +1305,22 @@ static Position* book_probe(const Book *book, const Board *board)
 	return position_array_probe(book->array + (board_get_hash_code(&unique) & (book->n - 1)), &unique);
 }
 
+/**
+ * @brief Drop the book index attached to the book's search.
+ *
+ * The index built by "book feed-hash" is a snapshot of the book, so it is
+ * dropped as soon as the book changes, and has to be built again.
+ *
+ * @param book Opening book.
+ */
+void book_drop_index(Book *book)
+{
+	if (book->search && book->search->book_index) {
+		book_index_free(book->search->book_index);
+		book->search->book_index = NULL;
+	}
+}
+
 /**
  * @brief Add a position to the book.
  *
@@ -1312,6 +1331,7 @@ static void book_add(Book *book, const Position *p)
 {
 	const unsigned long long i = board_get_hash_code(&p->board) & (book->n - 1);
 
+	book_drop_index(book);
 	if (position_array_add(book->array + i, p)) {
 		++book->n_nodes;
 		++book->stats.n_nodes;
@@ -1328,6 +1348,7 @@ static void book_remove(Book *book, const Position *p)
 {
 	const unsigned long long i = board_get_hash_code(&p->board) & (book->n - 1);
 
+	book_drop_index(book);
 	if (position_array_remove(book->array + i, p)) {
 		--book->n_nodes;
 		--book->stats.n_nodes;
@@ -1343,6 +1364,8 @@ static void book_clean(Book *book)
 {
 	PositionArray *a;
 	Position *p;
+
+	book_drop_index(book);
 	book->stats.n_nodes = book->stats.n_links = book->stats.n_todo = 0;
 	foreach_position(p, a, book) p->done = p->todo = false;
 }
@@ -1402,6 +1425,8 @@ void book_init(Book *book)
 void book_free(Book *book)
 {
 	int i;
+
+	book_drop_index(book);
 	for (i = 0; i < book->n; ++i) {
 		position_array_free(book->array + i);
 	}
@@ -1440,7 +1465,10 @@ void book_new(Book *book, int level, int n_empties)
  */
 void book_load(Book *book, const char *file)
 {
-	FILE *f = fopen(file, "rb");
+	FILE *f;
+
+	book_drop_index(book);
+	f = fopen(file, "rb");
 	if (f) {
 		Position p;
 		unsigned int header_edax, header_book;
@@ -1646,6 +1674,443 @@ void book_merge(Book *dest, const Book *src)
 	}
 }
 
+/** Number of positions sorted in memory per run during a streaming merge */
+static const int BOOK_MERGE_RUN_SIZE = 1 << 22;
+
+/**
+ * @brief A sorted run of positions, stored in a temporary file.
+ */
+typedef struct BookRun {
+	FILE *f;          /**< temporary file */
+	Position p;       /**< current position */
+	int n;            /**< number of positions left to read */
+	int source;       /**< 0 = destination book, 1 = source book */
+} BookRun;
+
+/**
+ * @brief Compare two positions by their (unique) board.
+ *
+ * @param a First position.
+ * @param b Second position.
+ * @return -1, 0 or 1.
+ */
+static int position_compare(const void *a, const void *b)
+{
+	const Board *x = &((const Position*) a)->board;
+	const Board *y = &((const Position*) b)->board;
+
+	if (x->player != y->player) return x->player < y->player ? -1 : 1;
+	if (x->opponent != y->opponent) return x->opponent < y->opponent ? -1 : 1;
+	return 0;
+}
+
+/**
+ * @brief Check if run a is behind run b in the merge order.
+ *
+ * On equal boards, runs from the destination book come first.
+ *
+ * @param a First run.
+ * @param b Second run.
+ * @return true if a > b.
+ */
+static bool book_run_greater(const BookRun *a, const BookRun *b)
+{
+	const int c = position_compare(&a->p, &b->p);
+	return c > 0 || (c == 0 && a->source > b->source);
+}
+
+/**
+ * @brief Restore the heap property of a min-heap of runs.
+ *
+ * @param heap Heap of runs.
+ * @param n Heap size.
+ * @param i Index of the run to sift down.
+ */
+static void book_run_sift(BookRun **heap, const int n, int i)
+{
+	BookRun *r = heap[i];
+	int j;
+
+	while ((j = 2 * i + 1) < n) {
+		if (j + 1 < n && book_run_greater(heap[j], heap[j + 1])) ++j;
+		if (!book_run_greater(r, heap[j])) break;
+		heap[i] = heap[j];
+		i = j;
+	}
+	heap[i] = r;
+}
+
+/**
+ * @brief Read the next position of a run.
+ *
+ * @param run Run.
+ * @return false at the end of the run.
+ */
+static bool book_run_next(BookRun *run)
+{
+	if (run->n == 0) return false;
+	if (!position_read(&run->p, run->f)) fatal_error("cannot read a temporary merge file\n");
+	--run->n;
+	return true;
+}
+
+/**
+ * @brief Read and check the header of a binary opening book.
+ *
+ * @param book Book receiving the header settings.
+ * @param f Input stream.
+ * @param file File name (for error messages).
+ * @return true if the header is valid.
+ */
+static bool book_read_header(Book *book, FILE *f, const char *file)
+{
+	unsigned int header_edax, header_book;
+	unsigned char header_version, header_release;
+	int r;
+
+	r = fread(&header_edax, sizeof (unsigned int), 1, f);
+	r += fread(&header_book, sizeof (unsigned int), 1, f);
+	if (r != 2 || header_edax != EDAX || header_book != BOOK) {
+		error("%s is not an edax opening book", file);
+		return false;
+	}
+
+	r = fread(&header_version, 1, 1, f);
+	r += fread(&header_release, 1, 1, f);
+	if (r != 2 || header_version != VERSION) {
+		error("%s is not a compatible version", file);
+		return false;
+	}
+
+	r = fread(&book->date, sizeof book->date, 1, f);
+	r += fread(&book->options, sizeof book->options, 1, f);
+	r += fread(&book->n_nodes, sizeof book->n_nodes, 1, f);
+	if (r != 3) {
+		error("Cannot read book settings from %s", file);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Split a binary opening book into sorted runs.
+ *
+ * At most BOOK_MERGE_RUN_SIZE positions are kept in memory at once. Each
+ * run is sorted by board and written into a temporary file.
+ *
+ * @param file Book file name.
+ * @param source Source tag of the runs.
+ * @param runs Array of runs (reallocated).
+ * @param n_runs Number of runs (updated).
+ * @param header Book receiving the header settings.
+ * @return true in case of success.
+ */
+static bool book_split_runs(const char *file, const int source, BookRun **runs, int *n_runs, Book *header)
+{
+	FILE *f = fopen(file, "rb");
+	Position *chunk;
+	int i, n, n_left;
+	bool ok = true;
+
+	if (f == NULL) {
+		error("cannot open %s", file);
+		return false;
+	}
+	if (!book_read_header(header, f, file)) {
+		fclose(f);
+		return false;
+	}
+
+	chunk = (Position*) malloc(BOOK_MERGE_RUN_SIZE * sizeof (Position));
+	if (chunk == NULL) fatal_error("cannot allocate space to sort the positions\n");
+
+	for (n_left = header->n_nodes; ok && n_left > 0; n_left -= n) {
+		n = MIN(n_left, BOOK_MERGE_RUN_SIZE);
+		for (i = 0; i < n; ++i) {
+			if (!position_read(chunk + i, f)) fatal_error("error while reading %s: %d positions missing\n", file, n_left - i);
+		}
+
+		qsort(chunk, n, sizeof (Position), position_compare);
+
+		*runs = (BookRun*) realloc(*runs, (*n_runs + 1) * sizeof (BookRun));
+		if (*runs == NULL) fatal_error("cannot allocate the merge runs\n");
+		(*runs)[*n_runs].f = tmpfile();
+		(*runs)[*n_runs].n = n;
+		(*runs)[*n_runs].source = source;
+		if ((*runs)[*n_runs].f == NULL) {
+			error("cannot create a temporary file");
+			ok = false;
+		} else {
+			for (i = 0; i < n && ok; ++i) ok = position_write(chunk + i, (*runs)[*n_runs].f);
+			rewind((*runs)[*n_runs].f);
+			++*n_runs;
+		}
+		for (i = 0; i < n; ++i) position_free(chunk + i);
+		bprint("Sorting %s... %d runs\r", file, *n_runs);
+	}
+
+	free(chunk);
+	fclose(f);
+
+	return ok;
+}
+
+/**
+ * @brief Find a position among the sorted positions of a level.
+ *
+ * @param level Positions sorted by board.
+ * @param n Number of positions.
+ * @param board Board to find (or a symetry).
+ * @return the position or NULL if no position is found.
+ */
+static Position* book_level_probe(Position *level, const int n, const Board *board)
+{
+	Position key;
+
+	board_unique(board, &key.board);
+	return (Position*) bsearch(&key, level, n, sizeof (Position), position_compare);
+}
+
+/**
+ * @brief Link & negamax a position from the positions of its children level.
+ *
+ * Equivalent to position_link(), position_search() for positions without
+ * leaf move, position_negamax() & position_sort(), but with the children
+ * looked up among the already negamaxed positions of the next level.
+ *
+ * @param position Position.
+ * @param level Negamaxed positions with one disc more, sorted by board.
+ * @param n Number of positions in the level.
+ * @param book Opening book settings.
+ */
+static void position_relink(Position *position, Position *level, const int n, Book *book)
+{
+	GameStats stat = {0,0,0,0};
+	unsigned long long moves = board_get_moves(&position->board);
+	Board next;
+	Link link, *l;
+	Position *child;
+	int x;
+
+	if (moves) {
+		foreach_bit(x, moves) {
+			board_next(&position->board, x, &next);
+			child = book_level_probe(level, n, &next);
+			if (child) {
+				link.score = -child->score.value;
+				link.move = x;
+				book->stats.n_links += position_add_link(position, &link);
+			}
+		}
+	} else if (can_move(position->board.opponent, position->board.player)) {// pass ?
+		next.player = position->board.opponent;
+		next.opponent = position->board.player;
+		child = book_level_probe(level, n, &next);
+		if (child) {
+			link.score = -child->score.value;
+			link.move = PASS;
+			book->stats.n_links += position_add_link(position, &link);
+		}
+	}
+
+	if (position->leaf.move == NOMOVE) position_search(position, book);
+
+	position_negamax_leaf(position, book, &stat);
+	foreach_link(l, position) {
+		board_next(&position->board, l->move, &next);
+		child = book_level_probe(level, n, &next);
+		if (child) position_negamax_link(position, l, child, book, &stat);
+		else if (l->score > position->score.value) position->score.value = l->score;
+	}
+	position_set_stats(position, &stat);
+
+	position_sort(position);
+}
+
+/**
+ * @brief Link & negamax the positions of a book, one level at a time.
+ *
+ * Positions are processed by increasing number of empty squares, so the
+ * children of a position are all negamaxed when it is reached. Only the
+ * scores of two levels are kept in memory. Positions that must pass are
+ * processed last within their level, as their child has the same number
+ * of empty squares.
+ *
+ * @param level Temporary files of positions, by number of empty squares.
+ * @param n_level Number of positions in each file.
+ * @param book Opening book settings & search.
+ * @param f Output stream.
+ * @return true in case of success.
+ */
+static bool book_relink_levels(FILE **level, const int *n_level, Book *book, FILE *f)
+{
+	Position *prev = NULL, *next = NULL, *pass = NULL;
+	int e, i, n_prev = 0, n_next, n_pass, n_done = 0;
+	bool ok = true;
+
+	for (e = 0; e <= 60 && ok; ++e) {
+		if (n_level[e] == 0) {
+			free(prev);
+			prev = NULL;
+			n_prev = 0;
+			continue;
+		}
+		next = (Position*) malloc(n_level[e] * sizeof (Position));
+		pass = (Position*) malloc(n_level[e] * sizeof (Position));
+		if (next == NULL || pass == NULL) fatal_error("cannot allocate space to negamax the positions\n");
+
+		rewind(level[e]);
+		for (i = n_next = n_pass = 0; i < n_level[e] && ok; ++i) {
+			Position *p = next + n_next;
+			if (!position_read(p, level[e])) fatal_error("cannot read a temporary merge file\n");
+			if (!board_get_moves(&p->board) && can_move(p->board.opponent, p->board.player)) {
+				pass[n_pass++] = *p;
+				continue;
+			}
+			position_relink(p, prev, n_prev, book);
+			ok = position_write(p, f);
+			position_free(p);
+			p->link = NULL; p->n_link = 0;
+			++n_next;
+			if (++n_done % BOOK_INFO_RESOLUTION == 0) bprint("Negamaxing book... %d positions\r", n_done);
+		}
+		qsort(next, n_next, sizeof (Position), position_compare);
+
+		for (i = 0; i < n_pass; ++i) {
+			if (ok) {
+				position_relink(pass + i, next, n_next, book);
+				ok = position_write(pass + i, f);
+			}
+			position_free(pass + i);
+			pass[i].link = NULL; pass[i].n_link = 0;
+			next[n_next + i] = pass[i];
+			++n_done;
+		}
+		if (n_pass) qsort(next, n_next + n_pass, sizeof (Position), position_compare);
+
+		free(pass);
+		free(prev);
+		prev = next;
+		n_prev = n_next + n_pass;
+	}
+	free(prev);
+
+	return ok;
+}
+
+/**
+ * @brief Merge two opening book files without loading them in memory.
+ *
+ * Both books are split into runs sorted by board, then all the runs are
+ * merged with a k-way merge, following book_merge() semantics: positions
+ * of the destination book are kept as is, positions only found in the
+ * source book are added with their leaf move only. The merged positions
+ * are finally linked & negamaxed one level at a time into the output file,
+ * as "book fix" would do.
+ *
+ * @param book Opening book, whose search evaluates the positions without leaf move.
+ * @param dest_file Destination opening book file.
+ * @param src_file Source opening book file.
+ * @param out_file Output opening book file.
+ */
+void book_merge_files(Book *book, const char *dest_file, const char *src_file, const char *out_file)
+{
+	unsigned int header_edax = EDAX, header_book = BOOK;
+	unsigned char header_version = VERSION, header_release = RELEASE;
+	Book header, src_header;
+	BookRun *runs = NULL, **heap = NULL;
+	FILE *level[61] = {NULL};
+	int n_level[61] = {0};
+	Position p;
+	int i, n, e, n_runs = 0;
+	FILE *f = NULL;
+	int r;
+
+	info("Merging %s & %s into %s...\n", dest_file, src_file, out_file);
+
+	if (!book_split_runs(dest_file, 0, &runs, &n_runs, &header)
+	 || !book_split_runs(src_file, 1, &runs, &n_runs, &src_header)) {
+		error("cannot merge %s & %s", dest_file, src_file);
+		goto book_merge_files_end;
+	}
+
+	for (e = 0; e <= 60; ++e) {
+		if ((level[e] = tmpfile()) == NULL) {
+			error("cannot create a temporary file");
+			goto book_merge_files_end;
+		}
+	}
+
+	heap = (BookRun**) malloc(n_runs * sizeof (BookRun*));
+	if (heap == NULL) fatal_error("cannot allocate the merge heap\n");
+	for (i = n = 0; i < n_runs; ++i) {
+		if (book_run_next(runs + i)) heap[n++] = runs + i;
+	}
+	for (i = n / 2 - 1; i >= 0; --i) book_run_sift(heap, n, i);
+
+	header.n_nodes = 0;
+	r = 1;
+	while (r && n > 0) {
+		BookRun *top = heap[0];
+		const Board board = top->p.board;
+
+		// on equal boards, a position from the destination book comes first and is kept as is.
+		if (top->source == 0) p = top->p;
+		else {
+			position_merge(&p, &top->p);
+			position_free(&top->p);
+		}
+		do {
+			if (!book_run_next(top)) heap[0] = heap[--n];
+			if (n > 0) book_run_sift(heap, n, 0);
+			if (n == 0 || !board_equal(&heap[0]->p.board, &board)) break;
+			top = heap[0];
+			position_free(&top->p);
+		} while (true);
+
+		e = board_count_empties(&p.board);
+		r = position_write(&p, level[e]);
+		position_free(&p);
+		++n_level[e];
+		++header.n_nodes;
+
+		if (header.n_nodes % BOOK_INFO_RESOLUTION == 0) bprint("Merging book... %d positions\r", header.n_nodes);
+	}
+	if (!r) {
+		error("cannot write a temporary file");
+		goto book_merge_files_end;
+	}
+	info("%d positions merged\n", header.n_nodes);
+
+	if ((f = fopen(out_file, "wb")) == NULL) {
+		error("cannot open %s", out_file);
+		goto book_merge_files_end;
+	}
+
+	book_set_date(&header);
+	r = fwrite(&header_edax, sizeof (unsigned int), 1, f);
+	r += fwrite(&header_book, sizeof (unsigned int), 1, f);
+	r += fwrite(&header_version, 1, 1, f);
+	r += fwrite(&header_release, 1, 1, f);
+	r += fwrite(&header.date, sizeof header.date, 1, f);
+	r += fwrite(&header.options, sizeof header.options, 1, f);
+	r += fwrite(&header.n_nodes, sizeof header.n_nodes, 1, f);
+
+	header.stats.n_nodes = header.stats.n_links = header.stats.n_todo = 0;
+	header.need_saving = false;
+	header.search = book->search;
+	if (r != 7 || !book_relink_levels(level, n_level, &header, f)) error("cannot write %s", out_file);
+	else info("%d positions linked & negamaxed\n", header.n_nodes);
+	fclose(f);
+
+book_merge_files_end:
+	for (e = 0; e <= 60; ++e) if (level[e]) fclose(level[e]);
+	for (i = 0; i < n_runs; ++i) fclose(runs[i].f);
+	free(heap);
+	free(runs);
+}
+
 /**
  * @brief Negamax a book.
  *
@@ -2271,30 +2736,27 @@ void book_add_board(Book *book, const Board *board)
 }
 
 /**
- * @brief Add positions from a game.
+ * @brief Replay the first moves of a game.
  *
- * @param book opening book.
- * @param game game to add.
+ * @param game Game to replay.
+ * @param n_plies Maximal number of plies to replay.
+ * @param board Board reached after the replayed moves.
+ * @param stack Played moves, including passes.
+ * @return the number of moves in the stack, or -1 for a non standard game.
  */
-void book_add_game(Book *book, const Game *game)
+static int game_replay(const Game *game, const int n_plies, Board *board, Move *stack)
 {
-	Board board;
-	Move stack[99];
 	int i, n_moves;
-	char file[FILENAME_MAX + 1];
-	const int n_stats = book->stats.n_nodes + book->stats.n_links;
 
-	file_add_ext(options.book_file, ".gam", file);
-	
-	board_init(&board);
-	if (!board_equal(&board, &game->initial_board)) return; // skip non standard game
-	for (i = n_moves = 0; i < 60 - book->options.n_empties && game->move[i] != NOMOVE; ++i) {
-		if (!can_move(board.player, board.opponent)) {
+	board_init(board);
+	if (!board_equal(board, &game->initial_board)) return -1; // skip non standard game
+	for (i = n_moves = 0; i < n_plies && game->move[i] != NOMOVE; ++i) {
+		if (!can_move(board->player, board->opponent)) {
 			stack[n_moves++] = MOVE_PASS;
-			board_pass(&board);
+			board_pass(board);
 		}
-		if (!board_is_occupied(&board, game->move[i]) && board_get_move_flip(&board, game->move[i], &stack[n_moves])) {
-			board_update(&board, stack + n_moves);
+		if (!board_is_occupied(board, game->move[i]) && board_get_move_flip(board, game->move[i], &stack[n_moves])) {
+			board_update(board, stack + n_moves);
 			++n_moves;
 		} else {
 			warn("illegal move in game");
@@ -2302,6 +2764,28 @@ void book_add_game(Book *book, const Game *game)
 		}
 	}
 
+	return n_moves;
+}
+
+/**
+ * @brief Add positions from a game.
+ *
+ * @param book opening book.
+ * @param game game to add.
+ */
+void book_add_game(Book *book, const Game *game)
+{
+	Board board;
+	Move stack[99];
+	int n_moves;
+	char file[FILENAME_MAX + 1];
+	const int n_stats = book->stats.n_nodes + book->stats.n_links;
+
+	file_add_ext(options.book_file, ".gam", file);
+	
+	n_moves = game_replay(game, 60 - book->options.n_empties, &board, stack);
+	if (n_moves < 0) return; // skip non standard game
+
 	search_cleanup(book->search);
 	while (--n_moves >= 0) {
 		book_add_board(book, &board);
@@ -2311,9 +2795,489 @@ void book_add_game(Book *book, const Game *game)
 	if (book->stats.n_nodes + book->stats.n_links > n_stats && book_get_age(book) > 3600) book_save(book, file);
 }
 
+/** Number of games replayed per work item during a parallel update */
+#define BOOK_GAME_CHUNK 64
+
+/**
+ * @brief A visit of a position while adding games.
+ *
+ * Visits are dated as the serial path would make them: game after game, the
+ * deepest position of a game first. The visits of a position follow each
+ * other, by date; the first one also keeps the state of the position before
+ * the update.
+ */
+typedef struct BookVisit {
+	Board board;                     /**< (unique) board */
+	long long date;                  /**< date of the visit */
+	int score;                       /**< position score after the visit */
+	int initial_score;               /**< position score before the update (first visit) */
+	int n_visits;                    /**< number of visits of the position (first visit) */
+	bool is_new;                     /**< position not in the book before the update (first visit) */
+} BookVisit;
+
+/**
+ * @brief Shared state of a parallel book update.
+ */
+typedef struct BookAddShared {
+	Book *book;                      /**< opening book */
+	const Base *base;                /**< games to add or check */
+	MoveHash hash;                   /**< already checked positions, with sharded locks */
+	Lock lock;                       /**< lock on the work queue */
+	int next;                        /**< next work item */
+	int last;                        /**< end of the work items */
+	BookVisit *visit;                /**< visits, sorted by board & date */
+	int n_visits;                    /**< number of visits */
+	BookVisit **todo;                /**< first visit of each position, in update order */
+	Position *added;                 /**< new positions */
+} BookAddShared;
+
+/**
+ * @brief A thread of a parallel book update.
+ */
+typedef struct BookAddTask {
+	Thread thread;                   /**< thread */
+	BookAddShared *shared;           /**< shared state */
+	Book book;                       /**< view of the book with its own search */
+	BookVisit *visit;                /**< visits made by this thread */
+	int n_visits;                    /**< number of visits */
+	int size;                        /**< capacity of the visit array */
+	int n_games;                     /**< number of replayed games */
+	struct BookCheckGame *stat;      /**< check statistics */
+} BookAddTask;
+
+/**
+ * @brief Get the next work items.
+ *
+ * @param shared Shared state.
+ * @param n Maximal number of items.
+ * @param last Last item (excluded).
+ * @return the first item.
+ */
+static int book_add_next(BookAddShared *shared, const int n, int *last)
+{
+	int first;
+
+	lock(shared);
+	first = shared->next;
+	shared->next = *last = MIN(first + n, shared->last);
+	unlock(shared);
+
+	return first;
+}
+
+/**
+ * @brief Replay games and record the visited positions.
+ *
+ * @param v Book update thread.
+ * @return NULL.
+ */
+static void* book_add_task_replay(void *v)
+{
+	BookAddTask *task = (BookAddTask*) v;
+	BookAddShared *shared = task->shared;
+	const int n_empties = task->book.options.n_empties;
+	BookVisit *visit;
+	Board board;
+	Move stack[99];
+	int i, k, last, n_moves;
+
+	while ((i = book_add_next(shared, BOOK_GAME_CHUNK, &last)) < last) {
+		for (; i < last; ++i) {
+			n_moves = game_replay(shared->base->game + i, 60 - n_empties, &board, stack);
+			for (k = 0; --n_moves >= 0; ++k) {
+				if (board_count_empties(&board) >= n_empties - 1) {
+					if (task->n_visits == task->size) {
+						task->size += task->size / 2 + 1024;
+						task->visit = (BookVisit*) realloc(task->visit, task->size * sizeof (BookVisit));
+						if (task->visit == NULL) fatal_error("cannot allocate the positions to add\n");
+					}
+					visit = task->visit + task->n_visits++;
+					board_unique(&board, &visit->board);
+					visit->date = (long long) i * 128 + k;
+				}
+				board_restore(&board, stack + n_moves);
+			}
+			++task->n_games;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Compare two boards.
+ *
+ * @param x First board.
+ * @param y Second board.
+ * @return -1, 0 or 1.
+ */
+static int book_board_compare(const Board *x, const Board *y)
+{
+	if (x->player != y->player) return x->player < y->player ? -1 : 1;
+	if (x->opponent != y->opponent) return x->opponent < y->opponent ? -1 : 1;
+	return 0;
+}
+
+/**
+ * @brief Compare two visits by board, then by date.
+ *
+ * @param a First visit.
+ * @param b Second visit.
+ * @return -1, 0 or 1.
+ */
+static int book_visit_compare(const void *a, const void *b)
+{
+	const BookVisit *x = (const BookVisit*) a;
+	const BookVisit *y = (const BookVisit*) b;
+	const int c = book_board_compare(&x->board, &y->board);
+
+	if (c) return c;
+	return x->date < y->date ? -1 : (x->date > y->date);
+}
+
+/**
+ * @brief Update stage of a position.
+ *
+ * Children have to be updated before their parent: positions are updated by
+ * increasing number of empties, and a position that has to pass after its
+ * child, which has the same number of empties.
+ *
+ * @param visit Visit of the position.
+ * @return the update stage.
+ */
+static int book_visit_stage(const BookVisit *visit)
+{
+	return 2 * board_count_empties(&visit->board) + (can_move(visit->board.player, visit->board.opponent) ? 0 : 1);
+}
+
+/**
+ * @brief Compare two positions by update stage, then by date of first visit.
+ *
+ * @param a First visit of the first position.
+ * @param b First visit of the second position.
+ * @return -1, 0 or 1.
+ */
+static int book_visit_compare_order(const void *a, const void *b)
+{
+	const BookVisit *x = *(const BookVisit* const*) a;
+	const BookVisit *y = *(const BookVisit* const*) b;
+	const int s_x = book_visit_stage(x), s_y = book_visit_stage(y);
+
+	if (s_x != s_y) return s_x < s_y ? -1 : 1;
+	return x->date < y->date ? -1 : (x->date > y->date);
+}
+
+/**
+ * @brief Score of a child position, as seen by the serial path at a date.
+ *
+ * @param shared Shared state.
+ * @param board Child position.
+ * @param score Child score, before its visits by the update.
+ * @param date Date of the parent visit.
+ * @return the child score, or -SCORE_INF if the child is not in the book yet.
+ */
+static int book_add_child_score(const BookAddShared *shared, const Board *board, const int score, const long long date)
+{
+	Board unique;
+	const BookVisit *visit, *first;
+	int l = 0, r = shared->n_visits;
+
+	board_unique(board, &unique);
+	while (l < r) { // first visit of the child
+		const int m = (l + r) / 2;
+		if (book_board_compare(&shared->visit[m].board, &unique) < 0) l = m + 1; else r = m;
+	}
+	first = shared->visit + l;
+	if (l == shared->n_visits || book_board_compare(&first->board, &unique) != 0) return score;
+
+	for (visit = first + first->n_visits; --visit >= first;) {
+		if (visit->date < date) return visit->score;
+	}
+
+	return first->is_new ? -SCORE_INF : first->initial_score;
+}
+
+/**
+ * @brief Link a position at a visit.
+ *
+ * Same as position_link(), but each child is seen as the serial path would
+ * see it at this date: the children the update adds later are ignored, and
+ * the scores are those of the children at that time.
+ *
+ * @param task Book update thread.
+ * @param position Position to link.
+ * @param date Date of the visit.
+ */
+static void book_add_link(BookAddTask *task, Position *position, const long long date)
+{
+	Book *book = &task->book;
+	int x;
+	unsigned long long moves = board_get_moves(&position->board);
+	Board next;
+	Link link;
+	Position *child;
+
+	if (moves) {
+		foreach_bit(x, moves) {
+			board_next(&position->board, x, &next);
+			child = book_probe(book, &next);
+			if (child && (link.score = book_add_child_score(task->shared, &next, child->score.value, date)) != -SCORE_INF) {
+				link.score = -link.score;
+				link.move = x;
+				book->stats.n_links += position_add_link(position, &link);
+			}
+		}
+	} else if (can_move(position->board.opponent, position->board.player)) {// pass ?
+		next.player = position->board.opponent;
+		next.opponent = position->board.player;
+		child = book_probe(book, &next);
+		if (child && (link.score = book_add_child_score(task->shared, &next, child->score.value, date)) != -SCORE_INF) {
+			link.score = -link.score;
+			link.move = PASS;
+			book->stats.n_links += position_add_link(position, &link);
+		}
+	}
+}
+
+/**
+ * @brief Replay the visits of the positions of a stage.
+ *
+ * Each visit does what book_add_board() does: a new position is linked &
+ * searched at its first visit, then at each visit a position is linked, and
+ * searched again if its best remaining move was linked. Positions already in
+ * the book are updated in place, new positions are built aside and added to
+ * the book after the stage.
+ *
+ * @param v Book update thread.
+ * @return NULL.
+ */
+static void* book_add_task_update(void *v)
+{
+	BookAddTask *task = (BookAddTask*) v;
+	BookAddShared *shared = task->shared;
+	BookVisit *first, *visit;
+	Position *p;
+	int i, last;
+
+	while ((i = book_add_next(shared, 1, &last)) < last) {
+		first = shared->todo[i];
+		p = book_probe(&task->book, &first->board);
+		first->is_new = (p == NULL);
+		if (p == NULL) {
+			p = shared->added + i;
+			position_init(p);
+			p->board = first->board;
+			p->level = task->book.options.level;
+		} else {
+			first->initial_score = p->score.value;
+		}
+		hash_clear(&task->book.search->hash_table);
+		hash_clear(&task->book.search->shallow_table);
+		for (visit = first; visit < first + first->n_visits; ++visit) {
+			book_add_link(task, p, visit->date);
+			if ((visit == first && first->is_new) || p->leaf.move == NOMOVE) position_search(p, &task->book);
+			visit->score = p->score.value;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Run a stage of a parallel book update.
+ *
+ * @param task Book update threads.
+ * @param n_task Number of threads.
+ * @param f Thread function.
+ * @param first First work item.
+ * @param last Last work item (excluded).
+ */
+static void book_add_run(BookAddTask *task, const int n_task, void* (*f)(void*), const int first, const int last)
+{
+	int i;
+
+	task->shared->next = first;
+	task->shared->last = last;
+	for (i = 1; i < n_task; ++i) thread_create(&task[i].thread, f, task + i);
+	f(task);
+	for (i = 1; i < n_task; ++i) thread_join(task[i].thread);
+}
+
+/**
+ * @brief Initialize the threads of a parallel book update.
+ *
+ * With searches, each thread gets a single-task search, whose hash tables
+ * share the size of the main ones.
+ *
+ * @param shared Shared state.
+ * @param book opening book.
+ * @param base games.
+ * @param n_task Number of threads.
+ * @param with_search Give each thread its own single-task search (add), or
+ *                    share a move hash (check).
+ * @return the threads.
+ */
+static BookAddTask* book_add_task_create(BookAddShared *shared, Book *book, const Base *base, const int n_task, const bool with_search)
+{
+	BookAddTask *task;
+	int i;
+	const int n = options.n_task, hash_table_size = options.hash_table_size;
+
+	task = (BookAddTask*) malloc(n_task * sizeof (BookAddTask));
+	if (task == NULL) fatal_error("cannot allocate the book threads\n");
+
+	shared->book = book;
+	shared->base = base;
+	shared->visit = NULL;
+	shared->n_visits = 0;
+	shared->todo = NULL;
+	shared->added = NULL;
+	if (!with_search) movehash_init(&shared->hash, options.hash_table_size);
+	lock_init(shared);
+
+	options.n_task = 1;
+	options.hash_table_size = MAX(hash_table_size - (n_task > 1 ? last_bit(n_task - 1) + 1 : 0), 16);
+	for (i = 0; i < n_task; ++i) {
+		task[i].shared = shared;
+		task[i].book = *book;
+		task[i].book.stats.n_nodes = task[i].book.stats.n_links = 0;
+		task[i].book.need_saving = false;
+		if (with_search) {
+			task[i].book.search = (Search*) mm_malloc(sizeof (Search));
+			if (task[i].book.search == NULL) fatal_error("cannot allocate the book searches\n");
+			search_init(task[i].book.search);
+			task[i].book.search->options.verbosity = 0;
+		}
+		task[i].visit = NULL;
+		task[i].n_visits = task[i].size = 0;
+		task[i].n_games = 0;
+		task[i].stat = NULL;
+	}
+	options.n_task = n;
+	options.hash_table_size = hash_table_size;
+	if (with_search) search_resize_hashtable(book->search); // share the memory budget
+
+	return task;
+}
+
+/**
+ * @brief Free the threads of a parallel book update.
+ *
+ * @param task Book update threads.
+ * @param n_task Number of threads.
+ * @param with_search Free the thread searches.
+ */
+static void book_add_task_free(BookAddTask *task, const int n_task, const bool with_search)
+{
+	BookAddShared *shared = task->shared;
+	int i;
+
+	for (i = 0; i < n_task; ++i) {
+		if (with_search) {
+			search_free(task[i].book.search);
+			mm_free(task[i].book.search);
+		}
+		free(task[i].visit);
+	}
+	if (!with_search) movehash_delete(&shared->hash);
+	lock_free(shared);
+	free(task);
+}
+
+/**
+ * @brief Add positions from a game database with several threads.
+ *
+ * Games are replayed in parallel, and each visited position is dated as the
+ * serial path would visit it. Visited positions are then linked and searched
+ * in parallel, one stage at a time, children before parents. Within a stage
+ * no position depends on another one, and each is linked to the children the
+ * serial path would see at its visits. New positions are added to the book
+ * after each stage, in the order of their first visit; as in the serial path,
+ * the book is saved from time to time.
+ *
+ * @param book opening book.
+ * @param base games to add.
+ * @param n_task number of threads.
+ */
+static void book_add_base_parallel(Book *book, const Base *base, const int n_task)
+{
+	BookAddShared shared;
+	BookAddTask *task;
+	BookVisit *visit;
+	char file[FILENAME_MAX + 1];
+	int i, n, n_todo, n_stats, first, last, stage, n_games = 0;
+	long long t = -real_clock();
+
+	file_add_ext(options.book_file, ".gam", file);
+	task = book_add_task_create(&shared, book, base, n_task, true);
+
+	// replay the games & record the visited positions
+	book_add_run(task, n_task, book_add_task_replay, 0, base->n_games);
+
+	for (i = n = 0; i < n_task; ++i) {
+		n_games += task[i].n_games;
+		n += task[i].n_visits;
+	}
+	visit = (BookVisit*) malloc(MAX(n, 1) * sizeof (BookVisit));
+	if (visit == NULL) fatal_error("cannot allocate the positions to add\n");
+	for (i = n = 0; i < n_task; ++i) {
+		memcpy(visit + n, task[i].visit, task[i].n_visits * sizeof (BookVisit));
+		n += task[i].n_visits;
+		free(task[i].visit); task[i].visit = NULL;
+	}
+
+	// sort the visits by position & date
+	qsort(visit, n, sizeof (BookVisit), book_visit_compare);
+	shared.visit = visit;
+	shared.n_visits = n;
+
+	shared.todo = (BookVisit**) malloc(MAX(n, 1) * sizeof (BookVisit*));
+	shared.added = (Position*) malloc(MAX(n, 1) * sizeof (Position));
+	if (shared.todo == NULL || shared.added == NULL) fatal_error("cannot allocate the positions to add\n");
+	for (i = n_todo = 0; i < n; i += visit[i].n_visits) {
+		for (last = i + 1; last < n && book_board_compare(&visit[i].board, &visit[last].board) == 0; ++last) ;
+		visit[i].n_visits = last - i;
+		shared.todo[n_todo++] = visit + i;
+	}
+	qsort(shared.todo, n_todo, sizeof (BookVisit*), book_visit_compare_order);
+	bprint("Adding games...%d games replayed in %.1f s: %d positions to update\n", n_games, 0.001 * (t + real_clock()), n_todo);
+
+	// link & search the positions, one stage at a time.
+	for (first = 0; first < n_todo; first = last) {
+		stage = book_visit_stage(shared.todo[first]);
+		for (last = first + 1; last < n_todo && book_visit_stage(shared.todo[last]) == stage; ++last) ;
+		n_stats = book->stats.n_nodes + book->stats.n_links;
+		for (i = 0; i < n_task; ++i) task[i].book.stats.n_links = 0;
+
+		book_add_run(task, n_task, book_add_task_update, first, last);
+
+		for (i = first; i < last; ++i) {
+			if (shared.todo[i]->is_new) book_add(book, shared.added + i);
+		}
+		for (i = 0; i < n_task; ++i) {
+			book->stats.n_links += task[i].book.stats.n_links;
+			book->need_saving |= task[i].book.need_saving;
+		}
+		if (book->stats.n_nodes + book->stats.n_links > n_stats && book_get_age(book) > 3600) book_save(book, file);
+		bprint("Adding games...%d/%d positions done: %d positions, %d links\r", last, n_todo, book->stats.n_nodes, book->stats.n_links);
+	}
+
+	book_add_task_free(task, n_task, true);
+	free(shared.added);
+	free(shared.todo);
+	free(visit);
+
+	t += real_clock();
+	bprint("Adding games...%d/%d done: %d positions, %d links\n", n_games, base->n_games, book->stats.n_nodes, book->stats.n_links);
+	bprint("%d games added to book in %.1f s (%.0f games/s)\n", n_games, 0.001 * t, t > 0 ? 1000.0 * n_games / t : 0.0);
+}
+
 /**
  * @brief Add positions from a game database.
  *
+ * With several tasks (-n option), the games are added in parallel by
+ * book_add_base_parallel().
+ *
  * @param book opening book.
  * @param base games to add.
  */
@@ -2327,19 +3291,23 @@ void book_add_base(Book *book, const Base *base)
 
 	book_clean(book);
 	bprint("Adding %d games to book...\n", base->n_games);
-	t0 = real_clock();
-	for (i = 0; i < base->n_games; ++i) {
-		book_add_game(book, base->game + i);
-		t = real_clock();
-		if (t - t0 > 1000) {
-		    bprint("Adding games...%d/%d done: %d positions, %d links\r", i + 1, base->n_games, book->stats.n_nodes, book->stats.n_links);
-			t0 = t;
-		}
-		if (book->search->options.verbosity) putchar('\n');
-		
+	if (options.n_task > 1) {
+		book_add_base_parallel(book, base, options.n_task);
+	} else {
+		t0 = real_clock();
+		for (i = 0; i < base->n_games; ++i) {
+			book_add_game(book, base->game + i);
+			t = real_clock();
+			if (t - t0 > 1000) {
+			    bprint("Adding games...%d/%d done: %d positions, %d links\r", i + 1, base->n_games, book->stats.n_nodes, book->stats.n_links);
+				t0 = t;
+			}
+			if (book->search->options.verbosity) putchar('\n');
+			
+		}
+		bprint("Adding games...%d/%d done: %d positions, %d links\n", i, base->n_games, book->stats.n_nodes, book->stats.n_links);
+		bprint("%d games added to book\n", i);
 	}
-	bprint("Adding games...%d/%d done: %d positions, %d links\n", i, base->n_games, book->stats.n_nodes, book->stats.n_links);
-	bprint("%d games added to book\n", i);
 
 	book_save(book, file);
 }
@@ -2363,28 +3331,14 @@ void book_check_game(Book *book, MoveHash *hash, const Game *game, BookCheckGame
 	Board board;
 	Move stack[99], *iter;
 	MoveList movelist;
-	int i, n_moves;
+	int n_moves;
 	int bestscore;
 
-	board_init(&board);
-	if (!board_equal(&board, &game->initial_board)) return; // skip non standard game
-	for (i = n_moves = 0; i <= 60 - book->options.n_empties && game->move[i] != NOMOVE; ++i) {
-		if (!can_move(board.player, board.opponent)) {
-			stack[n_moves++] = MOVE_PASS;
-			board_pass(&board);
-		}
-		if (!board_is_occupied(&board, game->move[i]) && board_get_move_flip(&board, game->move[i], &stack[n_moves])) {
-			board_update(&board, stack + n_moves);
-			++n_moves;
-		} else {
-			warn("illegal move in game");
-			break; // stop, illegal moves
-		}
-	}
+	n_moves = game_replay(game, 61 - book->options.n_empties, &board, stack);
 
 	while (--n_moves >= 0) {
 		board_restore(&board, stack + n_moves);
-		if (movehash_append(hash, &board, stack[n_moves].x)) {
+		if (movehash_append_shared(hash, &board, stack[n_moves].x)) {
 			if (book_get_moves(book, &board, &movelist)) {
 				bestscore = movelist_first(&movelist)->score;
 				foreach_move(iter, movelist) {
@@ -2399,25 +3353,63 @@ void book_check_game(Book *book, MoveHash *hash, const Game *game, BookCheckGame
 	}
 }
 
+/**
+ * @brief Check positions from a slice of a game database.
+ *
+ * @param v Book update thread.
+ * @return NULL.
+ */
+static void* book_check_task(void *v)
+{
+	BookAddTask *task = (BookAddTask*) v;
+	BookAddShared *shared = task->shared;
+	int i, last;
+
+	while ((i = book_add_next(shared, BOOK_GAME_CHUNK, &last)) < last) {
+		task->n_games += last - i;
+		for (; i < last; ++i) book_check_game(&task->book, &shared->hash, shared->base->game + i, task->stat);
+	}
+
+	return NULL;
+}
+
 /**
  * @brief Check positions from a game database.
  *
+ * The games are checked by options.n_task threads, sharing the move hash
+ * that makes each position + move pair to be counted once.
+ *
  * @param book opening book.
  * @param base games to add.
  */
 void book_check_base(Book *book, const Base *base)
 {
+	BookCheckGame stat = {0, 0, 0}, *task_stat;
+	BookAddShared shared;
+	BookAddTask *task;
+	const int n_task = options.n_task;
 	int i;
-	BookCheckGame stat = {0, 0, 0};
-	MoveHash hash;
+	long long t = -real_clock();
 
 	bprint("Checking %d games to book...\n", base->n_games);
-	movehash_init(&hash, options.hash_table_size);
-	for (i = 0; i < base->n_games; ++i) {
-		book_check_game(book, &hash, base->game + i, &stat);
+	task = book_add_task_create(&shared, book, base, n_task, false);
+	task_stat = (BookCheckGame*) calloc(n_task, sizeof (BookCheckGame));
+	if (task_stat == NULL) fatal_error("cannot allocate the check statistics\n");
+	for (i = 0; i < n_task; ++i) task[i].stat = task_stat + i;
+
+	book_add_run(task, n_task, book_check_task, 0, base->n_games);
+
+	for (i = 0; i < n_task; ++i) {
+		stat.missing += task_stat[i].missing;
+		stat.good += task_stat[i].good;
+		stat.bad += task_stat[i].bad;
 	}
-	movehash_delete(&hash);
-    bprint("Positions : %llu missing, %llu good, %llu bad (%.2f%% bad)\n", stat.missing, stat.good, stat.bad, (100.0 * stat.bad)/(stat.bad + stat.good));
+	book_add_task_free(task, n_task, false);
+	free(task_stat);
+	t += real_clock();
+
+	bprint("Positions : %llu missing, %llu good, %llu bad (%.2f%% bad)\n", stat.missing, stat.good, stat.bad, (100.0 * stat.bad)/(stat.bad + stat.good));
+	bprint("%d games checked in %.1f s (%.0f games/s)\n", base->n_games, 0.001 * t, t > 0 ? 1000.0 * base->n_games / t : 0.0);
 }
 
 
@@ -2577,14 +3569,147 @@ void book_stats(Book *book)
 	fflush(stdout);
 }
 
+/**
+ * struct BookEntry
+ * @brief A position of the book index.
+ */
+typedef struct BookEntry {
+	Board board;               /**< (unique) board */
+	signed char score;         /**< position value */
+	unsigned char move;        /**< best move, on the unique board */
+	unsigned char level;       /**< search level */
+	unsigned char n_empties;   /**< empty square number */
+} BookEntry;
+
+/**
+ * struct BookIndex
+ * @brief Compact read-only copy of the book, as an open addressing hash table.
+ */
+struct BookIndex {
+	BookEntry *entry;          /**< entries (empty if board is 0) */
+	unsigned long long mask;   /**< entry number - 1 */
+	int min_empties;           /**< lowest empty square number of the book positions */
+};
+
+/**
+ * @brief Build the book index.
+ *
+ * @param book Opening book.
+ * @return a new book index.
+ */
+static BookIndex* book_index_create(const Book *book)
+{
+	BookIndex *index;
+	BookEntry *entry;
+	PositionArray *a;
+	Position *p;
+	MoveList movelist;
+	unsigned long long size;
+	int n_empties;
+
+	index = (BookIndex*) malloc(sizeof (BookIndex));
+	for (size = 1024; size < 2ULL * book->n_nodes; size <<= 1) ;
+	if (index) index->entry = (BookEntry*) calloc(size, sizeof (BookEntry));
+	if (index == NULL || index->entry == NULL) fatal_error("cannot allocate the book index\n");
+	index->mask = size - 1;
+	index->min_empties = 61;
+
+	foreach_position(p, a, book) {
+		entry = index->entry + (board_get_hash_code(&p->board) & index->mask);
+		while (entry->board.player | entry->board.opponent)
+			if (++entry > index->entry + index->mask) entry = index->entry;
+
+		n_empties = board_count_empties(&p->board);
+		if (n_empties < index->min_empties) index->min_empties = n_empties;
+
+		position_get_moves(p, &p->board, &movelist);
+		entry->board = p->board;
+		entry->score = p->score.value;
+		entry->move = movelist_is_empty(&movelist) ? NOMOVE : movelist_first(&movelist)->x;
+		entry->level = p->level;
+		entry->n_empties = n_empties;
+	}
+
+	return index;
+}
+
+/**
+ * @brief Memory used by the book index.
+ *
+ * @param index Book index (may be NULL).
+ * @return Size in bytes.
+ */
+unsigned long long book_index_memory(const BookIndex *index)
+{
+	return index ? (index->mask + 1) * sizeof (BookEntry) + sizeof (BookIndex) : 0;
+}
+
+/**
+ * @brief Free the book index.
+ *
+ * @param index Book index.
+ */
+void book_index_free(BookIndex *index)
+{
+	if (index) {
+		free(index->entry);
+		free(index);
+	}
+}
+
+/**
+ * @brief Feed the hash tables from the book index.
+ *
+ * Called by the search at every node while the book is in use: only the book
+ * positions actually visited are fed, with the book score as exact bounds,
+ * unless the hash table already holds a deeper result. Positions with fewer
+ * empties than the deepest book position return at once.
+ *
+ * @param search Search, at a position to probe.
+ * @param hash_code Position hash code.
+ * @param is_pv Flag to feed a protected pv entry.
+ */
+void book_probe_hash(Search *search, const unsigned long long hash_code, const bool is_pv)
+{
+	const BookIndex *index = search->book_index;
+	const BookEntry *entry;
+	Board unique;
+	HashData data;
+	HashStoreData hash_data;
+	int s;
+
+	if (search->eval.n_empties < index->min_empties) return;
+
+	s = board_unique(&search->board, &unique);
+	entry = index->entry + (board_get_hash_code(&unique) & index->mask);
+	while (!board_equal(&entry->board, &unique)) {
+		if ((entry->board.player | entry->board.opponent) == 0) return;
+		if (++entry > index->entry + index->mask) entry = index->entry;
+	}
+
+	hash_data.data.wl.c.depth = LEVEL[entry->level][entry->n_empties].depth;
+	hash_data.data.wl.c.selectivity = LEVEL[entry->level][entry->n_empties].selectivity;
+	if (hash_get(&search->hash_table, &search->board, hash_code, &data) && data.wl.c.depth >= hash_data.data.wl.c.depth
+	 && data.wl.c.selectivity >= hash_data.data.wl.c.selectivity) return;
+
+	hash_data.data.lower = hash_data.data.upper = entry->score;
+	hash_data.data.move[0] = symetry(entry->move, (s == 5 || s == 6) ? s ^ 3 : s);	// inverse symetry
+	if (is_pv) hash_feed_pv(&search->hash_table, &search->board, hash_code, &hash_data);
+	else hash_feed(&search->hash_table, &search->board, hash_code, &hash_data);
+}
+
 /**
  * @brief feed hash table from the opening book.
- * 
+ *
+ * Rather than walking the book sub-tree from the current position, a compact
+ * copy of the book is attached to the search, which then probes it lazily.
+ *
  * @param book Opening book.
- * @param board Position to start from.
  * @param search HashTables container.
  */
-void book_feed_hash(const Book *book, Board *board, Search *search)
+void book_feed_hash(const Book *book, Search *search)
 {
-	board_feed_hash(board, book, search, true);
+	book_index_free(search->book_index);
+	search->book_index = book_index_create(book);
+	search_resize_hashtable(search);
 }
@@ -69,6 +69,7 @@ void book_save(Book*, const char*);
 void book_import(Book*, const char*);
 void book_export(Book*, const char*);
 void book_merge(Book*, const Book*);
+void book_merge_files(Book*, const char*, const char*, const char*);
 void book_sort(Book *book);
 void book_negamax(Book*);
 void book_prune(Book*);
@@ -98,7 +99,13 @@ void book_check_base(Book*, const Base*);
 void book_extract_skeleton(Book*, Base*);
 void book_extract_positions(Book*, const int, const int);
 
-void book_feed_hash(const Book*, Board*, Search*);
+typedef struct BookIndex BookIndex;
+
+void book_feed_hash(const Book*, Search*);
+void book_probe_hash(Search*, const unsigned long long, const bool);
+void book_drop_index(Book*);
+void book_index_free(BookIndex*);
+unsigned long long book_index_memory(const BookIndex*);
 
 #endif /* EDAX_BOOK_H */
 
@@ -201,7 +201,6 @@ static bool is_position_new(Engine *engine, Board *board)
 	engine->last_position.board[0] = *board;
 	engine->last_position.n = MIN(ENGINE_N_POSITION, engine->last_position.n + 1);
 	hash_clear(&engine->search->hash_table);
-	hash_clear(&engine->search->pv_table);
 	hash_clear(&engine->search->shallow_table);
 	
 	return true;
@@ -288,7 +287,6 @@ static int engine_open(Search *search, const Board *board, const int player, con
 	search_time_init(search);
 	if (!search->options.keep_date) {
 		hash_clear(&search->hash_table);
-		hash_clear(&search->pv_table);
 		hash_clear(&search->shallow_table);
 	}
 
@@ -302,7 +300,7 @@ static int engine_open(Search *search, const Board *board, const int player, con
 	if (player != search->player || !board_equal(&search->board, board)) {
 		search_set_board(search, board, player);
 
-		if (hash_get_from_board(&search->pv_table, board, &hash_data)) {
+		if (hash_get_from_board(&search->hash_table, board, &hash_data)) {
 			if (hash_data.lower == -SCORE_INF && hash_data.upper < SCORE_INF) score = hash_data.upper;
 			else if (hash_data.upper == +SCORE_INF && hash_data.lower > -SCORE_INF) score = hash_data.lower;
 			else score = (hash_data.upper + hash_data.lower) / 2;
@@ -422,8 +420,7 @@ void feed_all_hash_table(Search *search, Board *board, const int depth, const in
 	hash_data.data.move[0] = move;
 	hash_data.data.lower = lower;
 	hash_data.data.upper = upper;
-	hash_feed(&search->hash_table, board, hash_code, &hash_data);
-	hash_feed(&search->pv_table, board, hash_code, &hash_data);
+	hash_feed_pv(&search->hash_table, board, hash_code, &hash_data);
 }
 
 /**
@@ -513,7 +510,6 @@ void engine_empty_hash(void *v)
 		cassio_debug("clear the hash-table.\n");
 		engine->last_position.n = 0;
 		hash_cleanup(&engine->search->hash_table);
-		hash_cleanup(&engine->search->pv_table);
 		hash_cleanup(&engine->search->shallow_table);
 	}
 }
@@ -538,8 +534,7 @@ static bool skip_search(Engine *engine, int *old_score)
 	
 	*old_score = 0;
 	
-	if (hash_get(&search->pv_table, &search->board, hash_code, &hash_data)
-	|| hash_get(&search->hash_table, &search->board, hash_code, &hash_data)) {
+	if (hash_get(&search->hash_table, &search->board, hash_code, &hash_data)) {
 		// compute bounds
 		if (alpha < hash_data.lower) alpha = *old_score = hash_data.lower;
 		if (beta > hash_data.upper) beta = *old_score = hash_data.upper;
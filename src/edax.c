@@ -50,6 +50,7 @@
  *   -new <n1> <n2>       create a new empty book with level <n1> and depth <n2>.
  *   -load [file]         load an opening book from a binary opening file.
  *   -merge [file]        merge an opening book with the current opening book.
+ *   -merge-files <f1> <f2> <out>  merge two opening book files into a fixed <out>, out of memory.
  *   -save [file]         save an opening book to a binary opening file.
  *   -import [file]       load an opening book from a portable text file.
  *   -export [file]       save an opening book to a portable text file.
@@ -76,15 +77,19 @@
  *   -correct [file_in] [n]            correct error in the last <n> moves.
  *   -complete [file_in]               complete a database by playing the last\n  missing moves.
  *   -problem [file_in] [n] [file_out] build a set of <n> problems from a game\n  database.
+ *   -opening [file_in] [file_out]     write the opening names of the games.
  *
  * Tests commands:
  *   -solve [file]        solve a set of positions.
  *   -obftest [file]      Test from an obf file.
  *   -script-to-obf [file]Convert a script to an obf file.
  *   -wtest [file]        check the theoric scores of a wthor base file.
+ *   -weval [d] [files]   compare the scores at depth [d] (default: level) to the\n  theoric scores of wthor base files.
+ *   -match [n] [A] [B] [p] play <n> games between engines [A] & [B], configured as\n  l=<level>,h=<hash size>,t=<time per move>,n=<nodes per move>, from <p> random plies.
  *   -count games [d]     compute the number of moves from the current position up\n  to depth [d].
  *   -perft [d]           same as above, but without hash table.
- *   -estimate [d] [n]    estimate the number of moves from the current position up\n  to depth [d].
+ *   -estimate [n] [e]    estimate the number of moves & games from the current position
+ *                        with [n] random games, or until a relative error [e] is reached.
  *   -count positions [d] compute the number of positions from the current position\n  up to depth [d].
  *   -count shapes [d]    compute the number of shapes from the current position up\n  to depth [d].
  *
@@ -106,6 +111,8 @@
 #include "search.h"
 #include "util.h"
 #include "ui.h"
+
+#include <ctype.h>
 #ifdef __linux__
 	#include <sys/time.h>
 	#include <sys/resource.h>
@@ -223,6 +230,8 @@ void help_book(void)
 		"  new <n1> <n2>       create a new empty book with level <n1> and depth <n2>.\n"
 		"  load [file]         load an opening book from a binary opening file.\n"
 		"  merge [file]        merge an opening book with the current opening book.\n"
+		"  merge-files <f1> <f2> <out>\n"
+		"                      merge two opening book files into a fixed <out>, out of memory.\n"
 		"  save [file]         save an opening book to a binary opening file.\n"
 		"  import [file]       load an opening book from a portable text file.\n"
 		"  export [file]       save an opening book to a portable text file.\n"
@@ -255,7 +264,8 @@ void help_base(void)
 		"  check [file_in] [n]              check error in the last <n> moves.\n"
 		"  correct [file_in] [n]            correct error in the last <n> moves.\n"
 		"  complete [file_in]               complete a database by playing the last\n  missing moves.\n"
-		"  problem [file_in] [n] [file_out] build a set of <n> problems from a game\n  database.\n");
+		"  problem [file_in] [n] [file_out] build a set of <n> problems from a game\n  database.\n"
+		"  opening [file_in] [file_out]     write the opening names of the games.\n");
 }
 
 /**
@@ -269,9 +279,12 @@ void help_test(void)
 		"  obftest [file]      Test from an obf file.\n"
 		"  script-to-obf [file]Convert a script to an obf file.\n"
 		"  wtest [file]        check the theoric scores of a wthor base file.\n"
+		"  weval [d] [files]   compare the scores at depth [d] (default: level) to the\n  theoric scores of wthor base files.\n"
+		"  match [n] [A] [B] [p] play <n> games between engines [A] & [B], configured as\n  l=<level>,h=<hash size>,t=<time per move>,n=<nodes per move>, from <p> random plies.\n"
 		"  count games [d]     compute the number of moves from the current position up\n  to depth [d].\n"
 		"  perft [d]           same as above, but without hash table.\n"
-		"  estimate [d] [n]    estimate the number of moves from the current position up\n  to depth [d].\n"
+		"  estimate [n] [e]    estimate the number of moves & games from the current position\n"
+		"                      with [n] random games, or until a relative error [e] is reached.\n"
 		"  count positions [d] compute the number of positions from the current position\n  up to depth [d].\n"
 		"  count shapes [d]    compute the number of shapes from the current position up\n  to depth [d].\n");
 }
@@ -502,10 +515,13 @@ void ui_loop_edax(UI *ui)
 			
 			// game/position enumeration
 			} else if (strcmp(cmd, "estimate") == 0) {
+				const char *arg = param;
 				int n = 1000;
-				n = string_to_int(param, 10); BOUND(n, 1, 2000000000, "max-trials");
+				double error = 0.0;
+				arg = parse_int(arg, &n); BOUND(n, 1, 2000000000, "max-trials");
+				parse_real(arg, &error); BOUND(error, 0.0, 1.0, "relative error");
 
-				estimate_games(&play->board, n);
+				estimate_games(&play->board, n, error);
 	
 			// seek highest mobility
 			} else if (strcmp(cmd, "mobility") == 0) {
@@ -547,11 +563,33 @@ void ui_loop_edax(UI *ui)
 
 			// wtest test the engine against wthor theoretical scores
 			} else if (strcmp(cmd, "weval") == 0) {
-				wthor_eval(param, &play->search, histogram);
+				const char *files = param, *s;
+				int depth = -1;
+				for (s = files; isdigit(*s); ++s) ;
+				if (s > files && (*s == '\0' || isspace(*s))) { // a number, not a file name like 1990.wtb
+					files = parse_int(files, &depth); BOUND(depth, 0, 60, "depth");
+				}
+				wthor_eval(files, &play->search, depth, histogram);
 				histogram_print(histogram);
 				histogram_stats(histogram);
 				histogram_to_ppm("weval.ppm", histogram);
 
+			// play a match between two engine configurations
+			} else if (strcmp(cmd, "match") == 0) {
+				MatchEngine engine[2];
+				char spec[2][256];
+				const char *match_param = param;
+				int n_games = 2, n_plies = 8;
+				match_param = parse_int(match_param, &n_games); BOUND(n_games, 1, 1000000, "n_games");
+				match_param = parse_word(match_param, spec[0], 255);
+				match_param = parse_word(match_param, spec[1], 255);
+				match_param = parse_int(match_param, &n_plies); BOUND(n_plies, 0, 60, "n_plies");
+				if (!play_match_engine(spec[0], engine) || !play_match_engine(spec[1], engine + 1)) {
+					warn("Bad engine configuration: \"%s\" vs \"%s\"\n", spec[0], spec[1]);
+				} else {
+					play_match(engine, n_games, n_plies);
+				}
+
 			// go think!
 			} else if (strcmp(cmd, "go") == 0) {
 				if (play_is_game_over(play)) printf("\n*** Game Over ***\n");
@@ -623,6 +661,7 @@ void ui_loop_edax(UI *ui)
 				int val_1, val_2;
 				Book *book = play->book;
 
+				play_stop_pondering(play); // the book index may be dropped under the search
 				book->search = &play->search;
 				book->search->options.verbosity = book->options.verbosity;
 				book_param = parse_word(param, book_cmd, FILENAME_MAX);
@@ -638,6 +677,7 @@ void ui_loop_edax(UI *ui)
 				// turn book usage off
 				} else if (strcmp(book_cmd, "off") == 0) { // learn
 					options.book_allowed = false;
+					book_drop_index(book);
 
 				// set book randomness
 				} else if (strcmp(book_cmd, "randomness") == 0) { // learn
@@ -692,6 +732,14 @@ void ui_loop_edax(UI *ui)
 					book_free(&src);
 					warn("Book needs to be fixed before usage\n");
 
+				// merge two opening book files without loading them
+				} else if (strcmp(book_cmd, "merge-files") == 0) {
+					char src_file[FILENAME_MAX], out_file[FILENAME_MAX];
+					book_param = parse_word(book_param, book_file, FILENAME_MAX);
+					book_param = parse_word(book_param, src_file, FILENAME_MAX);
+					parse_word(book_param, out_file, FILENAME_MAX);
+					book_merge_files(book, book_file, src_file, out_file);
+
 				// fix an opening book
 				} else if (strcmp(book_cmd, "fix") == 0) {
 					book_fix(book); // do nothing (or edax is buggy)
@@ -811,7 +859,7 @@ void ui_loop_edax(UI *ui)
 
 				// add book positions to the hash table
 				} else if (strcmp(book_cmd, "feed-hash") == 0) {
-					book_feed_hash(book, &play->board, &play->search);
+					book_feed_hash(book, &play->search);
 
 				// wrong command ?
 				} else {
@@ -849,6 +897,14 @@ void ui_loop_edax(UI *ui)
 
 					base_load(&base, base_file);
 					base_to_FEN(&base, n_empties, problem_file);
+
+				// annotate the games with their opening names
+				} else if (strcmp(base_cmd, "opening") == 0) {
+					char opening_file[FILENAME_MAX + 1];
+					base_param = parse_word(base_param, opening_file, FILENAME_MAX);
+
+					base_load(&base, base_file);
+					base_to_opening(&base, opening_file);
 	
 				// correct erroneous games
 				} else if (strcmp(base_cmd, "correct") == 0) {
@@ -19,7 +19,9 @@
 
 #include <assert.h>
 
-#if LAST_FLIP_COUNTER == COUNT_LAST_FLIP_CARRY
+#if defined(LAST_FLIP_SOURCE)	// alternative kernel with the interface of LAST_FLIP_COUNTER (see harness.c)
+	#include LAST_FLIP_SOURCE
+#elif LAST_FLIP_COUNTER == COUNT_LAST_FLIP_CARRY
 	#include "count_last_flip_carry_64.c"
 #elif LAST_FLIP_COUNTER == COUNT_LAST_FLIP_SSE
 	#ifdef hasSSE2
@@ -398,6 +400,8 @@ static int search_solve_4(Search *search, int alpha)
  * This function is used when there are few empty squares on the board. Here,
  * optimizations are in favour of speed instead of efficiency.
  * Move ordering is constricted to the hole parity and the type of squares.
+ * With USE_REGION_PARITY, holes are the connected empty regions, single square
+ * regions being played first.
  * No hashtable are used and anticipated cut-off is limited to stability cut-off.
  *
  * @param search Search.
@@ -407,6 +411,9 @@ static int search_solve_4(Search *search, int alpha)
 static int search_shallow(Search *search, const int alpha)
 {
 	unsigned long long moves, prioritymoves;
+#if USE_REGION_PARITY
+	unsigned long long oddmoves;
+#endif
 	int x, prev, score, bestscore;
 	// const int beta = alpha + 1;
 	V2DI board0;
@@ -436,7 +443,15 @@ static int search_shallow(Search *search, const int alpha)
 
 	bestscore = -SCORE_INF;
 	parity0 = search->eval.parity;
+#if USE_REGION_PARITY
+	oddmoves = get_odd_regions(~(board0.board.player | board0.board.opponent), &prioritymoves);
+	oddmoves &= moves;
+	prioritymoves &= moves;	// single square regions first
+	if (prioritymoves == 0)
+		prioritymoves = oddmoves;
+#else
 	prioritymoves = moves & quadrant_mask[parity0];
+#endif
 	if (prioritymoves == 0)	// all even
 		prioritymoves = moves;
 
@@ -460,7 +475,11 @@ static int search_shallow(Search *search, const int alpha)
 				else if (score > bestscore)
 					bestscore = score;
 			} while (prioritymoves);	// (34%)
+#if USE_REGION_PARITY
+		} while ((prioritymoves = (moves & oddmoves) ? (moves & oddmoves) : moves));
+#else
 		} while ((prioritymoves = moves));	// (38%)
+#endif
 
 	else {
 		--search->eval.n_empties;	// for next depth
@@ -488,7 +507,11 @@ static int search_shallow(Search *search, const int alpha)
 				} else if (score > bestscore)
 					bestscore = score;
 			} while (prioritymoves);	// (54%)
+#if USE_REGION_PARITY
+		} while ((prioritymoves = (moves & oddmoves) ? (moves & oddmoves) : moves));
+#else
 		} while ((prioritymoves = moves));	// (23%)
+#endif
 		++search->eval.n_empties;
 	}
 	search->board = board0.board;
@@ -498,6 +521,66 @@ static int search_shallow(Search *search, const int alpha)
 	return bestscore;	// (33%)
 }
 
+/**
+ * @brief Enhanced Transposition Cutoff (ETC) for the endgame search.
+ *
+ * Before looping over the moves, look if a child position already stored in
+ * the hash table refutes the null window. All the child entries are
+ * prefetched at once first, so that their memory latencies overlap.
+ *
+ * @param search Current position.
+ * @param moves Head of the (size reduced) list of moves for the current position.
+ * @param hash_code Hashing code.
+ * @param alpha Alpha bound.
+ * @param score Score to return in case a cutoff is found.
+ * @return 'true' if a cutoff is found, 'false' otherwise.
+ */
+static bool search_ETC_endgame(Search *search, const Move *moves, unsigned long long hash_code, const int alpha, int *score)
+{
+	if (USE_ETC && search->eval.n_empties > ETC_MIN_EMPTIES) {
+		const Move *move;
+		Board next[DEPTH_MIDGAME_TO_ENDGAME];
+		unsigned long long etc_hash_code[DEPTH_MIDGAME_TO_ENDGAME];
+		HashData etc;
+		HashStoreData hash_data;
+		HashTable *hash_table = &search->hash_table;
+		const int etc_depth = search->eval.n_empties - 1;
+		int i;
+
+		CUTOFF_STATS(++statistics.n_etc_try;)
+		i = 0;
+		for (move = move_next(moves); move; move = move_next(move)) {
+			next[i].opponent = search->board.player ^ (move->flipped | x_to_bit(move->x));
+			next[i].player = search->board.opponent ^ move->flipped;
+			etc_hash_code[i] = board_get_hash_code(next + i);
+			hash_prefetch(hash_table, etc_hash_code[i]);
+			++i;
+		}
+
+		i = 0;
+		for (move = move_next(moves); move; move = move_next(move)) {
+			if (hash_get(hash_table, next + i, etc_hash_code[i], &etc) && etc.wl.c.selectivity >= NO_SELECTIVITY && etc.wl.c.depth >= etc_depth) {
+				*score = -etc.upper;
+				if (*score > alpha) {
+					hash_data.data.wl.c.depth = search->eval.n_empties;
+					hash_data.data.wl.c.selectivity = NO_SELECTIVITY;
+					hash_data.data.wl.c.cost = 0;
+					hash_data.data.move[0] = move->x;
+					hash_data.alpha = alpha;
+					hash_data.beta = alpha + 1;
+					hash_data.score = *score;
+					hash_store(hash_table, &search->board, hash_code, &hash_data);
+					CUTOFF_STATS(++statistics.n_etc_high_cutoff;)
+					return true;
+				}
+			}
+			++i;
+		}
+	}
+
+	return false;
+}
+
 /**
  * @brief Evaluate an endgame position with a Null Window Search algorithm.
  *
@@ -564,6 +647,9 @@ int NWS_endgame(Search *search, const int alpha)
 		}
 
 	} else {
+		// enhanced transposition cutoff
+		if (search_ETC_endgame(search, movelist.move, hash_code, alpha, &score)) return score;
+
 		movelist_evaluate_fast((MoveList *) &movelist, search, &hash_data.data);
 
 		board0.board = search->board;
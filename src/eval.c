@@ -706,6 +706,10 @@ void eval_open(const char* file)
 		EVAL_a = 0.07585621, EVAL_b = 1.16492647, EVAL_c = 5.4171698;
 	}
 
+#ifdef EVAL_PEXT
+	eval_pext_init();
+#endif
+
 	info("<Evaluation function weights version %u.%u.%u loaded>\n", version, release, build);
 
 	// f = fopen("eval.bin", "wb");
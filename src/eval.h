@@ -72,6 +72,10 @@ double eval_sigma(const int, const int, const int);
 #if defined(hasSSE2) || defined(__ARM_NEON) || defined(USE_MSVC_X86) || defined(ANDROID)
 void eval_update_sse(int, unsigned long long, Eval *, const Eval *);
 #endif
+#if defined(hasSSE2) && defined(__BMI2__) && defined(HAS_CPU_64) && !defined(__bdver4__) && !defined(__znver1__) && !defined(__znver2__) // pext is slow on AMD before Zen3
+	#define EVAL_PEXT
+void eval_pext_init(void);
+#endif
 #if defined(hasSSE2) || defined(__ARM_NEON)
 #define	eval_update(x, f, eval)	eval_update_sse(x, f, eval, eval)
 #define	eval_update_leaf(x, f, eval_out, eval_in)	eval_update_sse(x, f, eval_out, eval_in)
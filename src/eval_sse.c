@@ -9,11 +9,13 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 #include "bit_intrinsics.h"
 #include "board.h"
 #include "move.h"
 #include "eval.h"
+#include "settings.h"
 
 extern const EVAL_FEATURE_V EVAL_FEATURE[65];
 extern const EVAL_FEATURE_V EVAL_FEATURE_all_opponent;
@@ -192,9 +194,87 @@ void eval_update_sse(int x, unsigned long long f, Eval *eval_out, const Eval *ev
 
 #if defined(hasSSE2) || (defined(__ARM_NEON) && !defined(DISPATCH_NEON))
 
+#ifdef EVAL_PEXT
+
+/** size of the base-3 conversion tables: sum of 2^n_squares over the features */
+#define EVAL_PEXT_TABLE_SIZE 18881
+
+/** feature squares, base-3 conversion table & offset */
+static struct {
+	unsigned long long mask;
+	const unsigned short *base3;
+	unsigned short offset;
+} EVAL_PEXT_FEATURE[EVAL_N_FEATURE];
+
+/** base-3 conversion tables, shared by the features with the same square weights */
+static unsigned short EVAL_PEXT_BASE3[EVAL_PEXT_TABLE_SIZE];
+
+/**
+ * @brief Build the pext tables from EVAL_FEATURE.
+ *
+ * The squares of a feature, gathered by pext in bit order, index a table that
+ * converts them to the feature's base-3 weights.
+ */
+void eval_pext_init(void)
+{
+	unsigned short *t = EVAL_PEXT_BASE3;
+	unsigned short w[16];
+	unsigned int i, b, k;
+	int n[EVAL_N_FEATURE];
+	int f, g, x;
+
+	for (f = 0; f < EVAL_N_FEATURE; ++f) {
+		EVAL_PEXT_FEATURE[f].mask = 0;
+		EVAL_PEXT_FEATURE[f].offset = EVAL_FEATURE_all_opponent.us[f];
+		n[f] = 0;
+		for (x = A1; x <= H8; ++x) if (EVAL_FEATURE[x].us[f]) {
+			EVAL_PEXT_FEATURE[f].mask |= x_to_bit(x);
+			EVAL_PEXT_FEATURE[f].offset -= (w[n[f]++] = EVAL_FEATURE[x].us[f]);
+		}
+		assert(t + (1 << n[f]) <= EVAL_PEXT_BASE3 + EVAL_PEXT_TABLE_SIZE);
+
+		for (b = 0; b < (1u << n[f]); ++b)
+			for (t[b] = 0, i = b, k = 0; i; i >>= 1, ++k) if (i & 1) t[b] += w[k];
+
+		EVAL_PEXT_FEATURE[f].base3 = t;
+		for (g = 0; g < f; ++g) if (n[g] == n[f] && memcmp(EVAL_PEXT_FEATURE[g].base3, t, sizeof (*t) << n[f]) == 0) {
+			EVAL_PEXT_FEATURE[f].base3 = EVAL_PEXT_FEATURE[g].base3;
+			break;
+		}
+		if (EVAL_PEXT_FEATURE[f].base3 == t) t += 1 << n[f];
+	}
+}
+
+/**
+ * @brief Set up evaluation features from a board with pext.
+ *
+ * Each feature is computed directly from the opponent's discs (digit 1) and
+ * the empty squares (digit 2), at a fixed cost.
+ *
+ * @param eval  Evaluation function.
+ * @param board Board to setup features from.
+ */
+static void eval_set_pext(Eval *eval, const Board *board)
+{
+	const unsigned long long O = (eval->n_empties & 1) ? board->player : board->opponent;
+	const unsigned long long E = ~(board->opponent | board->player);
+	int f;
+
+	for (f = 0; f < EVAL_N_FEATURE; ++f) {
+		eval->feature.us[f] = EVAL_PEXT_FEATURE[f].offset
+			+ EVAL_PEXT_FEATURE[f].base3[_pext_u64(O, EVAL_PEXT_FEATURE[f].mask)]
+			+ 2 * EVAL_PEXT_FEATURE[f].base3[_pext_u64(E, EVAL_PEXT_FEATURE[f].mask)];
+	}
+	eval->feature.us[EVAL_N_FEATURE] = 0;
+}
+
+#endif // EVAL_PEXT
+
 /**
  * @brief Set up evaluation features from a board.
  *
+ * With pext, boards with many squares to walk are computed directly.
+ *
  * @param eval  Evaluation function.
  * @param board Board to setup features from.
  */
@@ -202,6 +282,13 @@ void eval_set(Eval *eval, const Board *board)
 {
 	int x;
 	unsigned long long b = (eval->n_empties & 1) ? board->opponent : board->player;
+
+  #ifdef EVAL_PEXT
+	if (64 - bit_count(b ^ board->opponent ^ board->player) >= EVAL_PEXT_MIN_SQUARES) {
+		eval_set_pext(eval, board);
+		return;
+	}
+  #endif
   #ifdef __AVX2__
 	__m256i	f0 = EVAL_FEATURE_all_opponent.v16[0];
 	__m256i	f1 = EVAL_FEATURE_all_opponent.v16[1];
@@ -278,14 +278,14 @@ static const V2DI mask[3][64] = { {
 	{{ ~0x0000000000000000, ~0x2010080402000000 }}, {{ ~0x0001000000000000, ~0x4020100804000000 }},
 	{{ ~0x0102000000000000, ~0x8040201008000000 }}, {{ ~0x0204000000000000, ~0x0080402010000000 }},
 	{{ ~0x0408000000000000, ~0x0000804020000000 }}, {{ ~0x0810000000000000, ~0x0000008040000000 }},
-	{{ ~0x1020000000000000, ~0x0000000080000000 }}, {{ ~0x2040000000000000, ~0x0000000000000000 }},
+	{{ ~0x1020000000000000, ~0x0000000080000000ULL }}, {{ ~0x2040000000000000, ~0x0000000000000000 }},
 	{{ ~0x0000000000000000, ~0x4020100804020000 }}, {{ ~0x0100000000000000, ~0x8040201008040000 }},
 	{{ ~0x0200000000000000, ~0x0080402010080000 }}, {{ ~0x0400000000000000, ~0x0000804020100000 }},
-	{{ ~0x0800000000000000, ~0x0000008040200000 }}, {{ ~0x1000000000000000, ~0x0000000080400000 }},
+	{{ ~0x0800000000000000, ~0x0000008040200000 }}, {{ ~0x1000000000000000, ~0x0000000080400000ULL }},
 	{{ ~0x2000000000000000, ~0x0000000000800000 }}, {{ ~0x4000000000000000, ~0x0000000000000000 }},
 	{{ ~0x0000000000000000, ~0x8040201008040200 }}, {{ ~0x0000000000000000, ~0x0080402010080400 }},
 	{{ ~0x0000000000000000, ~0x0000804020100800 }}, {{ ~0x0000000000000000, ~0x0000008040201000 }},
-	{{ ~0x0000000000000000, ~0x0000000080402000 }}, {{ ~0x0000000000000000, ~0x0000000000804000 }},
+	{{ ~0x0000000000000000, ~0x0000000080402000ULL }}, {{ ~0x0000000000000000, ~0x0000000000804000 }},
 	{{ ~0x0000000000000000, ~0x0000000000008000 }}, {{ ~0x0000000000000000, ~0x0000000000000000 }}
 }, {
 	{{ ~0x0101010101010100, ~0x0000000000000000 }}, {{ ~0x0202020202020200, ~0x0000000000000000 }},
@@ -323,16 +323,16 @@ static const V2DI mask[3][64] = { {
 }, {
 	{{ ~0x8040201008040200, ~0x0000000000000000 }}, {{ ~0x0080402010080400, ~0x0000000000000000 }},
 	{{ ~0x0000804020100800, ~0x0000000000000000 }}, {{ ~0x0000008040201000, ~0x0000000000000000 }},
-	{{ ~0x0000000080402000, ~0x0000000000000000 }}, {{ ~0x0000000000804000, ~0x0000000000000000 }},
+	{{ ~0x0000000080402000ULL, ~0x0000000000000000 }}, {{ ~0x0000000000804000, ~0x0000000000000000 }},
 	{{ ~0x0000000000008000, ~0x0000000000000000 }}, {{ ~0x0000000000000000, ~0x0000000000000000 }},
 	{{ ~0x4020100804020000, ~0x0000000000000000 }}, {{ ~0x8040201008040000, ~0x0100000000000000 }},
 	{{ ~0x0080402010080000, ~0x0200000000000000 }}, {{ ~0x0000804020100000, ~0x0400000000000000 }},
-	{{ ~0x0000008040200000, ~0x0800000000000000 }}, {{ ~0x0000000080400000, ~0x1000000000000000 }},
+	{{ ~0x0000008040200000, ~0x0800000000000000 }}, {{ ~0x0000000080400000ULL, ~0x1000000000000000 }},
 	{{ ~0x0000000000800000, ~0x2000000000000000 }}, {{ ~0x0000000000000000, ~0x4000000000000000 }},
 	{{ ~0x2010080402000000, ~0x0000000000000000 }}, {{ ~0x4020100804000000, ~0x0001000000000000 }},
 	{{ ~0x8040201008000000, ~0x0102000000000000 }}, {{ ~0x0080402010000000, ~0x0204000000000000 }},
 	{{ ~0x0000804020000000, ~0x0408000000000000 }}, {{ ~0x0000008040000000, ~0x0810000000000000 }},
-	{{ ~0x0000000080000000, ~0x1020000000000000 }}, {{ ~0x0000000000000000, ~0x2040000000000000 }},
+	{{ ~0x0000000080000000ULL, ~0x1020000000000000 }}, {{ ~0x0000000000000000, ~0x2040000000000000 }},
 	{{ ~0x1008040200000000, ~0x0000000000000000 }}, {{ ~0x2010080400000000, ~0x0000010000000000 }},
 	{{ ~0x4020100800000000, ~0x0001020000000000 }}, {{ ~0x8040201000000000, ~0x0102040000000000 }},
 	{{ ~0x0080402000000000, ~0x0204080000000000 }}, {{ ~0x0000804000000000, ~0x0408100000000000 }},
@@ -1535,15 +1535,24 @@ void game_rand(Game *game, int n_ply, Random *r)
 
  * Count how many mistakes occured in the last moves.
  *
+ * The positions are solved backward, from the end of the game toward the
+ * opening, within a single hash table generation, so that each search reuses
+ * the subtrees solved for the later positions. As the exact score of the
+ * played move is then already known, the alternative moves are searched with
+ * this score as lower bound: only a better alternative needs an exact score.
+ *
  * @param game Game to analyze.
  * @param search Search analyzer.
  * @param n_empties Move stage to analyze.
  * @param apply_correction Flag to correct or not a game.
+ * @param n_nodes Searched node counter (may be NULL).
  */
-int game_analyze(Game *game, Search *search, const int n_empties, const bool apply_correction)
+int game_analyze(Game *game, Search *search, const int n_empties, const bool apply_correction, unsigned long long *n_nodes)
 {
 	Board board;
 	struct {
+		Board board;
+		int player;
 		Move played;
 		Move best;
 		Line pv;
@@ -1552,34 +1561,28 @@ int game_analyze(Game *game, Search *search, const int n_empties, const bool app
 	int n_error = 0;
 	int n_move;
 	const int verbosity = search->options.verbosity;
+	const bool keep_date = search->options.keep_date;
 	int player;
 	int score;
 	int i;
 
-	search->options.verbosity = 0;
-	search_cleanup(search);
 	board = game->initial_board;
 	player = game->player;
 	for (i = n_move = 0; i < 60 && game->move[i] != NOMOVE; ++i) {
 		if (!can_move(board.player, board.opponent)) {
 			stack[n_move].best = MOVE_INIT;
 			line_init(&stack[n_move].pv, player);
+			stack[n_move].n_empties = board_count_empties(&board);
 			stack[n_move++].played = MOVE_PASS;
 			board_pass(&board);
 			player = !player;
 		} 
 		if (!board_is_occupied(&board, game->move[i]) && board_get_move_flip(&board, game->move[i], &stack[n_move].played)) {
+			stack[n_move].board = board;
+			stack[n_move].player = player;
 			stack[n_move].best = MOVE_INIT;
 			line_init(&stack[n_move].pv, player);
-			search_set_board(search, &board, player);
-			search_set_level(search, 60, search->eval.n_empties);
-			stack[n_move].n_empties = search->eval.n_empties;
-			if (search->movelist.n_moves > 1 && search->eval.n_empties <= n_empties) {
-				movelist_exclude(&search->movelist, game->move[i]);
-				search_run(search);
-				stack[n_move].best = *(movelist_first(&search->movelist));
-				stack[n_move].pv = search->result->pv;
-			}
+			stack[n_move].n_empties = board_count_empties(&board);
 			board_update(&board, &stack[n_move].played);
 			player = !player;
 			++n_move;
@@ -1593,19 +1596,42 @@ int game_analyze(Game *game, Search *search, const int n_empties, const bool app
 		}
 	}
 
+	search->options.verbosity = 0;
+	search->options.keep_date = false;
+	search_cleanup(search);
+
 	search_set_board(search, &board, player);
 	if (search->eval.n_empties <= n_empties) {
-		search_set_level(search, 60, search->eval.n_empties);
-		search_run(search);
-		score = search->result->score;
-		
-		for (i = n_move - 1; stack[i].n_empties <= n_empties; --i) {
+		if (board_is_game_over(&board)) {
+			score = search_solve(search);
+		} else {
+			search_set_level(search, 60, search->eval.n_empties);
+			search_run(search);
+			search->options.keep_date = true;
+			if (n_nodes) *n_nodes += search->result->n_nodes;
+			score = search->result->score;
+		}
+
+		// solve backward, the child's exact score bounding the alternatives.
+		for (i = n_move - 1; i >= 0 && stack[i].n_empties <= n_empties; --i) {
 			stack[i].played.score = -score;
+			if (stack[i].played.x != PASS && get_mobility(stack[i].board.player, stack[i].board.opponent) > 1) {
+				search_set_board(search, &stack[i].board, stack[i].player);
+				search_set_level(search, 60, search->eval.n_empties);
+				movelist_exclude(&search->movelist, stack[i].played.x);
+				search->options.alpha = MIN(stack[i].played.score, SCORE_MAX - 1);
+				search_run(search);
+				search->options.keep_date = true;
+				if (n_nodes) *n_nodes += search->result->n_nodes;
+				stack[i].best = *(movelist_first(&search->movelist));
+				stack[i].pv = search->result->pv;
+			}
 			score = MAX(stack[i].played.score, stack[i].best.score);
 		}
-		
-		//backpropagate the score
-		while (stack[--n_move].n_empties <= n_empties) {
+		search->options.alpha = SCORE_MIN;
+
+		//count the errors
+		while (n_move > 0 && stack[--n_move].n_empties <= n_empties) {
 			if (stack[n_move].played.score < stack[n_move].best.score) {
 				++n_error;
 				// correct the move?
@@ -1621,6 +1647,7 @@ int game_analyze(Game *game, Search *search, const int n_empties, const bool app
 	}
 
 	search->options.verbosity = verbosity;
+	search->options.keep_date = keep_date;
 
 	return n_error;
 }
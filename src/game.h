@@ -76,7 +76,7 @@ void game_export_svg(const Game*, FILE *);
 void game_import_oko(Game*, FILE*);
 void game_import_gam(Game*, FILE *);
 void game_rand(Game*, int, struct Random*);
-int game_analyze(Game*, struct Search*, const int, const bool);
+int game_analyze(Game*, struct Search*, const int, const bool, unsigned long long*);
 int game_complete(Game*, struct Search*);
 void line_to_game(const Board*, const Line*, Game*);
 int game_score(const Game*);
@@ -1,17 +1,45 @@
 /**
  * @file harness.c
  *
- * This module verifies if the move generator is correct.
+ * This module verifies if the move generator is correct, and measures its speed.
  *
- * @date 1998 - 2017
+ * The harness is built over the whole program (all.c), once per kernel, by
+ * "make harness". The flip kernel is selected by MOVE_GENERATOR, and the
+ * last flip counter by LAST_FLIP_COUNTER; FLIP_SOURCE & LAST_FLIP_SOURCE
+ * select an alternative source file sharing the same interface. Each kernel
+ * is checked against a slow reference on edge cases & random boards, then its
+ * speed is measured in CPU cycles per call, like in bench.c. The bulk
+ * evaluation scores (bulk-eval & pipe) are also checked against a plain
+ * alpha-beta search.
+ *
+ * @date 1998 - 2023
  * @author Richard Delorme
  * @version 4.4
  */
 
-#include "bit.h"
-#include "board.h"
+#define EDAX_HARNESS
+#include "all.c"
+
+/** @brief stringify a macro value */
+#define HARNESS_STR(x) HARNESS_STR2(x)
+/** @brief stringify a macro */
+#define HARNESS_STR2(x) #x
+
+/** number of boards per square for the speed test */
+#define HARNESS_N_BOARDS 1024
+
+/** central squares, never empty, that some kernels do not handle */
+#define HARNESS_CENTER 0x0000001818000000ULL
 
-unsigned long long flip_slow(const unsigned long long P, const unsigned long long O, const int x0)
+/**
+ * @brief Reference flip: walk each direction square by square.
+ *
+ * @param P player's discs.
+ * @param O opponent's discs.
+ * @param x0 move square.
+ * @return flipped discs.
+ */
+static unsigned long long flip_reference(const unsigned long long P, const unsigned long long O, const int x0)
 {
 	int x, d, dir[8] = {-9,-8,-7,-1,1,7,8,9};
 	const unsigned long long edge[8] = {
@@ -25,28 +53,385 @@ unsigned long long flip_slow(const unsigned long long P, const unsigned long lon
 		0xff80808080808080ull
 	};
 	unsigned long long flipped = 0, f;
-	char s[3];
-
-	if (x0 == PASS) return;
 
 	for (d = 0; d < 8; ++d) {
 		if ((x_to_bit(x0) & edge[d]) == 0) {
 			f = 0;
-			for (x = x0 + dir[d];  (O & x_to_bit(x)) && (x_to_bit(x) & edge[d]) == 0; x += dir[d]) {
+			for (x = x0 + dir[d]; (O & x_to_bit(x)) && (x_to_bit(x) & edge[d]) == 0; x += dir[d]) {
 				f |= x_to_bit(x);
 			}
-			if (board->player & x_to_bit(x)) flipped |= f;
+			if (P & x_to_bit(x)) flipped |= f;
 		}
 	}
 	return flipped;
+}
+
+/**
+ * @brief Build a test board with an empty square.
+ *
+ * Boards alternate between edge cases (full boards, a single player disc in an
+ * opponent's sea, lone discs) and random boards of various densities.
+ *
+ * @param x Empty square.
+ * @param i Board number.
+ * @param r Random generator.
+ * @param board Output board.
+ */
+static void harness_board(const int x, const unsigned long long i, Random *r, Board *board)
+{
+	const unsigned long long empty = ~x_to_bit(x);
+	unsigned long long a = random_get(r), b = random_get(r);
+
+	switch (i & 7) {
+	case 0: // full board
+		board->player = a & empty;
+		board->opponent = ~a & empty;
+		break;
+	case 1: // one player disc in an opponent's sea
+		board->player = x_to_bit((i >> 3) & 63) & empty;
+		board->opponent = ~board->player & empty;
+		break;
+	case 2: // a lone disc of each color
+		board->player = x_to_bit(a & 63) & empty;
+		board->opponent = x_to_bit(b & 63) & empty & ~board->player;
+		break;
+	case 3: // sparse board
+		board->player = a & b & random_get(r) & empty;
+		board->opponent = ~a & b & random_get(r) & empty;
+		break;
+	default: // random board
+		board->player = a & b & empty;
+		board->opponent = ~a & (b | random_get(r)) & empty;
+		break;
+	}
+}
+
+/**
+ * @brief Report a wrong result.
+ *
+ * @param name Function name.
+ * @param board Board.
+ * @param x Move.
+ * @param result Computed result.
+ * @param expected Expected result.
+ */
+static void harness_error(const char *name, const Board *board, const int x, const unsigned long long result, const unsigned long long expected)
+{
+	char s[4];
+
+	fprintf(stderr, "Bug found in %s[%s]()\n", name, move_to_string(x, BLACK, s));
+	board_print(board, BLACK, stderr);
+	fprintf(stderr, "result:\n"); bitboard_write(result, stderr);
+	fprintf(stderr, "expected:\n"); bitboard_write(expected, stderr);
+}
+
+/**
+ * @brief Cross-check the flip kernel against the reference.
+ *
+ * @param n Number of boards per square.
+ * @return the number of errors.
+ */
+static int harness_check_flip(const unsigned long long n)
+{
+	Board board;
+	Random r;
+	unsigned long long i, f, g;
+	int x, n_errors = 0;
 
-	
-if (move->flipped != flipped) {
-		printf("Bug found in flip[%s]()\n", move_to_string(move->x, 1, s));
-		board_print(board, 0, stdout);
-		bitboard_write(move->flipped, stdout);
-		bitboard_write(flipped, stdout);
-		abort();
+	random_seed(&r, 0x5eed);
+	for (x = A1; x <= H8; ++x)
+	if ((x_to_bit(x) & HARNESS_CENTER) == 0)
+	for (i = 0; i < n; ++i) {
+		harness_board(x, i, &r, &board);
+		f = Flip(x, board.player, board.opponent);
+		g = flip_reference(board.player, board.opponent, x);
+		if (f != g && n_errors++ < 4) harness_error("flip", &board, x, f, g);
 	}
+
+	return n_errors;
+}
+
+/**
+ * @brief Cross-check the last flip counter against the reference.
+ *
+ * On the last empty square, the opponent owns every other square and the
+ * counter returns twice the number of flipped discs.
+ *
+ * @param n Number of boards per square.
+ * @return the number of errors.
+ */
+static int harness_check_last_flip(const unsigned long long n)
+{
+	Board board;
+	Random r;
+	unsigned long long i;
+	int x, c, e, n_errors = 0;
+
+	random_seed(&r, 0x1a57);
+	for (x = A1; x <= H8; ++x)
+	if ((x_to_bit(x) & HARNESS_CENTER) == 0)
+	for (i = 0; i < n; ++i) {
+		harness_board(x, i, &r, &board);
+		board.opponent = ~(board.player | x_to_bit(x));
+		c = last_flip(x, board.player);
+		e = 2 * bit_count(flip_reference(board.player, board.opponent, x));
+		if (c != e && n_errors++ < 4) harness_error("last_flip", &board, x, c, e);
+	}
+
+	return n_errors;
+}
+
+/**
+ * @brief Measure the speed of the flip kernel.
+ *
+ * @param board Test boards, HARNESS_N_BOARDS per square.
+ * @return CPU cycles per call.
+ */
+static double harness_bench_flip(const Board *board)
+{
+	unsigned long long c, v = 0;
+	int x, i;
+
+	c = -click();
+	for (x = A1; x <= H8; ++x, board += HARNESS_N_BOARDS)
+	if ((x_to_bit(x) & HARNESS_CENTER) == 0)
+	for (i = 0; i < HARNESS_N_BOARDS; ++i) {
+		v += Flip(x, board[i].player, board[i].opponent);
+	}
+	c += click();
+	if (v == 1) putchar(' '); // keep the result alive
+
+	return (double) c / (60 * HARNESS_N_BOARDS);
 }
 
+/**
+ * @brief Measure the speed of the last flip counter.
+ *
+ * @param board Test boards, HARNESS_N_BOARDS per square.
+ * @return CPU cycles per call.
+ */
+static double harness_bench_last_flip(const Board *board)
+{
+	unsigned long long c, v = 0;
+	int x, i;
+
+	c = -click();
+	for (x = A1; x <= H8; ++x, board += HARNESS_N_BOARDS)
+	if ((x_to_bit(x) & HARNESS_CENTER) == 0)
+	for (i = 0; i < HARNESS_N_BOARDS; ++i) {
+		v += last_flip(x, board[i].player);
+	}
+	c += click();
+	if (v == 1) putchar(' '); // keep the result alive
+
+	return (double) c / (60 * HARNESS_N_BOARDS);
+}
+
+/**
+ * @brief Print a wrong bulk evaluation score.
+ *
+ * @param board Position.
+ * @param depth Search depth.
+ * @param result Score returned by bulk_score.
+ * @param expected Expected score.
+ */
+static void harness_bulk_error(const Board *board, const int depth, const int result, const int expected)
+{
+	fprintf(stderr, "Bug found in bulk_score(depth %d): %+d instead of %+d\n", depth, result, expected);
+	board_print(board, BLACK, stderr);
+}
+
+/**
+ * @brief Reference fixed-depth score: a plain alpha-beta over the evaluation.
+ *
+ * @param search Light search, used for the static evaluation.
+ * @param board Position.
+ * @param alpha Alpha bound.
+ * @param beta Beta bound.
+ * @param depth Search depth, or more than the empties to solve.
+ * @return The score, from the side to move.
+ */
+static int harness_bulk_reference(Search *search, const Board *board, int alpha, const int beta, const int depth)
+{
+	Board next;
+	Move move;
+	unsigned long long moves;
+	int score, bestscore = -SCORE_INF;
+
+	if (board->player == 0) return SCORE_MIN; // wipeout
+	if (depth == 0 || board_count_empties(board) == 0) return bulk_score(search, board, 0);
+
+	moves = board_get_moves(board);
+	if (moves == 0) {
+		next = *board;
+		board_pass(&next);
+		if (can_move(next.player, next.opponent)) return -harness_bulk_reference(search, &next, -beta, -alpha, depth);
+		search->board = *board;
+		search->eval.n_empties = board_count_empties(board);
+		return search_solve(search);
+	}
+
+	for (; moves; moves &= moves - 1) {
+		next = *board;
+		board_get_move_flip(&next, first_bit(moves), &move);
+		board_update(&next, &move);
+		score = -harness_bulk_reference(search, &next, -beta, -MAX(alpha, bestscore), depth - 1);
+		if (score > bestscore) {
+			bestscore = score;
+			if (bestscore >= beta) break;
+		}
+	}
+
+	return bestscore;
+}
+
+/**
+ * @brief Cross-check the bulk evaluation scores.
+ *
+ * Depths 0, 1 & 2 are compared to the reference alpha-beta, and the exact
+ * solve (depth >= empties) to the reference up to 12 empties, and to a full
+ * search above.
+ *
+ * @param n Number of random positions.
+ * @return the number of errors.
+ */
+static int harness_check_bulk(const int n)
+{
+	Search *light = bulk_search_create(60), search;
+	Board board;
+	Random r;
+	int i, depth, n_empties, c, e, n_errors = 0;
+
+	random_seed(&r, 0xb01c);
+	for (i = 0; i < n; ++i) {
+		board_rand(&board, 40 + i % 19, &r);
+		n_empties = board_count_empties(&board);
+		for (depth = 0; depth <= 2; ++depth) {
+			c = bulk_score(light, &board, depth);
+			e = harness_bulk_reference(light, &board, SCORE_MIN, SCORE_MAX, depth);
+			if (c != e && n_errors++ < 4) harness_bulk_error(&board, depth, c, e);
+		}
+		if (n_empties <= 12) {
+			c = bulk_score(light, &board, n_empties);
+			e = harness_bulk_reference(light, &board, SCORE_MIN, SCORE_MAX, 60);
+			if (c != e && n_errors++ < 4) harness_bulk_error(&board, n_empties, c, e);
+		}
+	}
+
+	search_init(&search);
+	search.options.verbosity = 0;
+	for (i = 0; i < 4; ++i) {
+		board_rand(&board, 43 + i, &r);
+		n_empties = board_count_empties(&board);
+		c = bulk_score(light, &board, 60);
+		search_cleanup(&search);
+		search_set_board(&search, &board, BLACK);
+		search_set_level(&search, 60, n_empties);
+		search_run(&search);
+		e = search.result->score;
+		if (c != e && n_errors++ < 4) harness_bulk_error(&board, n_empties, c, e);
+	}
+	search_free(&search);
+	bulk_search_free(light);
+
+	return n_errors;
+}
+
+/**
+ * @brief Check that the pipe board parser reads back the written boards.
+ *
+ * Both the board strings (from A1) and the FEN strings (from A8) written by
+ * board_to_string() & board_to_FEN() are parsed by parse_board_fast().
+ *
+ * @param n Number of random positions.
+ * @return the number of errors.
+ */
+static int harness_check_parse(const int n)
+{
+	Board board, parsed = {0, 0};
+	Random r;
+	char s[128];
+	int i, k, player, parsed_player = EMPTY, n_errors = 0;
+
+	random_seed(&r, 0xfe9);
+	for (i = 0; i < n; ++i) {
+		board_rand(&board, i % 61, &r);
+		player = i & 1;
+		for (k = 0; k < 2; ++k) {
+			if (k == 0) board_to_string(&board, player, s);
+			else board_to_FEN(&board, player, s);
+			if (parse_board_fast(s, &parsed, &parsed_player) == s || !board_equal(&board, &parsed) || parsed_player != player) {
+				if (n_errors++ < 4) fprintf(stderr, "Bug found in parse_board_fast: \"%s\" is not read back\n", s);
+			}
+		}
+	}
+
+	return n_errors;
+}
+
+/**
+ * @brief harness main function.
+ *
+ * Usage: harness [n], with n the number of checked boards per square, or
+ * harness bulk [eval file] to check the bulk evaluation scores & the pipe
+ * board parser.
+ *
+ * @param argc Number of arguments.
+ * @param argv Command line arguments.
+ * @return EXIT_FAILURE if a kernel is wrong.
+ */
+int main(int argc, char **argv)
+{
+	const unsigned long long n = argc > 1 ? strtoull(argv[1], NULL, 10) : 100000;
+	Board *board;
+	Random r;
+	int x, i, n_flip_errors, n_last_flip_errors, k;
+	double t_flip = 1e30, t_last_flip = 1e30;
+
+	bit_init();
+
+	if (argc > 1 && strcmp(argv[1], "bulk") == 0) {
+		options_bound();
+		hash_code_init();
+		hash_move_init();
+		eval_open(argc > 2 ? argv[2] : options.eval_file);
+		search_global_init();
+		k = harness_check_bulk(1000);
+		printf("%-32s %s\n", "bulk_score", k ? "FAILED" : "ok");
+		i = harness_check_parse(10000);
+		printf("%-32s %s\n", "parse_board_fast", i ? "FAILED" : "ok");
+		eval_close();
+		return (k || i) ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	n_flip_errors = harness_check_flip(n);
+	n_last_flip_errors = harness_check_last_flip(n);
+
+	board = (Board*) malloc(64 * HARNESS_N_BOARDS * sizeof (Board));
+	if (board == NULL) fatal_error("harness: cannot allocate boards\n");
+	random_seed(&r, 0xbe4c);
+	for (x = A1; x <= H8; ++x)
+	for (i = 0; i < HARNESS_N_BOARDS; ++i) {
+		harness_board(x, 4 + (i & 3), &r, board + x * HARNESS_N_BOARDS + i);
+	}
+	for (k = 0; k < 16; ++k) { // best of 16 runs
+		t_flip = MIN(t_flip, harness_bench_flip(board));
+		t_last_flip = MIN(t_last_flip, harness_bench_last_flip(board));
+	}
+	free(board);
+
+#ifdef FLIP_SOURCE
+	printf("%-32s", FLIP_SOURCE);
+#else
+	printf("%-32s", "MOVE_GENERATOR=" HARNESS_STR(MOVE_GENERATOR));
+#endif
+	printf(" %s %6.2f cycles/call\n", n_flip_errors ? "FAILED" : "ok    ", t_flip);
+#ifdef LAST_FLIP_SOURCE
+	printf("%-32s", LAST_FLIP_SOURCE);
+#else
+	printf("%-32s", "LAST_FLIP_COUNTER=" HARNESS_STR(LAST_FLIP_COUNTER));
+#endif
+	printf(" %s %6.2f cycles/call\n", n_last_flip_errors ? "FAILED" : "ok    ", t_last_flip);
+
+	return (n_flip_errors || n_last_flip_errors) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
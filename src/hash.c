@@ -13,6 +13,10 @@
  * The following implementation store the whole board to avoid collision. 
  * When doing parallel search with a shared hashtable, a locked implementation
  * avoid concurrency collisions.
+ * Entries stored from PV nodes are flagged with HASH_PV in their date: during
+ * the current search they rank above any other entry, so that the principal
+ * variation stays in the same bucket as the rest of the search, and a single
+ * probe finds it.
  *
  * @date 1998 - 2023
  * @author Richard Delorme
@@ -40,6 +44,9 @@ unsigned long long hash_move[64][60];
 /** HashData init value */
 const HashData HASH_DATA_INIT = {{{ 0, 0, 0, 0 }}, -SCORE_INF, SCORE_INF, { NOMOVE, NOMOVE }};
 
+/** external definition of the inline hash_entry */
+extern Hash* hash_entry(const HashTable*, const unsigned long long);
+
 /**
  * @brief Initialize global hash code data.
  */
@@ -103,10 +110,19 @@ void hash_init(HashTable *hash_table, const unsigned long long size)
 		size_t alignment = n_way * sizeof (Hash);	// (4 * 24)
 		alignment = (alignment & -alignment) - 1;	// LS1B - 1 (0x1f)
 		hash_table->hash = (Hash*) (((size_t) hash_table->memory + alignment) & ~alignment);
-		hash_table->hash_mask = size - n_way;
+		hash_table->bucket_size = n_way;
 	} else {
 		hash_table->hash = (Hash*) hash_table->memory;
-		hash_table->hash_mask = size - 1;
+		hash_table->bucket_size = 1;
+	}
+
+	// a power of 2 is indexed with a mask, other sizes by scaling the hash code
+	if ((size & (size - 1)) == 0) {
+		hash_table->n_bucket = 0;
+		hash_table->hash_mask = size - hash_table->bucket_size;
+	} else {
+		hash_table->n_bucket = size / hash_table->bucket_size;
+		hash_table->hash_mask = (hash_table->n_bucket - 1) * hash_table->bucket_size; // last bucket
 	}
 
 	hash_cleanup(hash_table);
@@ -127,7 +143,7 @@ void hash_init(HashTable *hash_table, const unsigned long long size)
  */
 void hash_cleanup(HashTable *hash_table)
 {
-	unsigned int i = 0, imax = hash_table->hash_mask + HASH_N_WAY;
+	unsigned long long i = 0, imax = hash_table->hash_mask + HASH_N_WAY;
 	Hash *pHash = hash_table->hash;
 
 	assert(hash_table != NULL && hash_table->hash != NULL);
@@ -169,6 +185,7 @@ void hash_cleanup(HashTable *hash_table)
 		pHash->data = HASH_DATA_INIT;
 	}
 	hash_table->date = 0;
+	hash_table->root = 0;
 }
 
 /**
@@ -187,6 +204,23 @@ void hash_clear(HashTable *hash_table)
 	assert(hash_table->date > 0 && hash_table->date <= 127);
 }
 
+/**
+ * @brief Set the root of the coming searches.
+ *
+ * A disc is never removed, so a position whose occupied squares do not cover
+ * those of the root cannot be reached anymore: its entry is evicted first.
+ * Entries of the previous moves that remain reachable are kept, aged by their
+ * date as usual.
+ * @param hash_table Hash table.
+ * @param board Root position.
+ */
+void hash_set_root(HashTable *hash_table, const Board *board)
+{
+	assert(hash_table != NULL);
+
+	hash_table->root = board->player | board->opponent;
+}
+
 /**
  * @brief Free the hashtable.
  *
@@ -219,6 +253,35 @@ inline unsigned int writeable_level(HashData *data)
 #endif
 }
 
+/**
+ * @brief make a replacement level: unreachable entries come first.
+ *
+ * @param hash_table Hash table.
+ * @param hash Hash entry.
+ * @return A level.
+ */
+static inline unsigned int replacement_level(const HashTable *hash_table, Hash *hash)
+{
+	unsigned int level;
+
+	if (hash_table->root & ~(hash->board.player | hash->board.opponent)) return 0;
+	level = writeable_level(&hash->data);
+	if (hash->data.wl.c.date != (hash_table->date | HASH_PV)) level &= ~((unsigned int) HASH_PV << 24);
+	return level;
+}
+
+/**
+ * @brief date of an updated entry: the pv flag of the current search is kept.
+ *
+ * @param old Previous date of the entry.
+ * @param date New date.
+ * @return The date to store.
+ */
+static inline unsigned char hash_date(const unsigned char old, const unsigned char date)
+{
+	return date | (old == (date | HASH_PV) ? HASH_PV : 0);
+}
+
 /**
  * @brief update an hash table item.
  *
@@ -399,7 +462,7 @@ static bool hash_update(Hash *hash, HashLock *lock, const Board *board, HashStor
 			if (hash->data.wl.us.selectivity_depth == storedata->data.wl.us.selectivity_depth)
 				data_update(&hash->data, storedata);
 			else	data_upgrade(&hash->data, storedata);
-			hash->data.wl.c.date = storedata->data.wl.c.date;
+			hash->data.wl.c.date = hash_date(hash->data.wl.c.date, storedata->data.wl.c.date);
 			if (hash->data.lower > hash->data.upper) { // reset the hash-table...
 				data_new(&hash->data, storedata);
 			}
@@ -438,6 +501,7 @@ static bool hash_replace(Hash *hash, HashLock *lock, const Board *board, HashSto
 	if (board_equal(&hash->board, board)) {
 		spin_lock(lock);
 		if (board_equal(&hash->board, board)) {
+			storedata->data.wl.c.date = hash_date(hash->data.wl.c.date, storedata->data.wl.c.date);
 			data_new(&hash->data, storedata);
 			ok = true;
 		}
@@ -473,7 +537,9 @@ static bool hash_reset(Hash *hash, HashLock *lock, const Board *board, HashStore
 				hash->data.lower = storedata->data.lower;
 				hash->data.upper = storedata->data.upper;
 			}
-			hash->data.wl = storedata->data.wl;
+			hash->data.wl.us.selectivity_depth = storedata->data.wl.us.selectivity_depth;
+			hash->data.wl.c.cost = storedata->data.wl.c.cost;
+			hash->data.wl.c.date = hash_date(hash->data.wl.c.date, storedata->data.wl.c.date);
 			if (storedata->data.move[0] != NOMOVE) {
 				// if (hash->data.move[0] != storedata->data.move[0]) {
 					hash->data.move[1] = hash->data.move[0];
@@ -499,25 +565,29 @@ static bool hash_reset(Hash *hash, HashLock *lock, const Board *board, HashStore
  * @param storedata.data.lower Alpha bound.
  * @param storedata.data.upper Beta bound.
  * @param storedata.move best move.
+ * @param tier HASH_PV for a pv entry, 0 otherwise.
  */
-void hash_feed(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata)
+static inline void hash_feed_tier(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata, const int tier)
 {
 	Hash *hash, *worst;
 	HashLock *lock; 
 	int i;
+	unsigned int level, l;
 
-	storedata->data.wl.c.date = hash_table->date ? hash_table->date : 1;
+	storedata->data.wl.c.date = (hash_table->date ? hash_table->date : 1) | tier;
 	storedata->data.wl.c.cost = 0;
 
-	worst = hash = hash_table->hash + (hash_code & hash_table->hash_mask);
+	worst = hash = hash_entry(hash_table, hash_code);
 	lock = hash_table->lock + (hash_code & hash_table->lock_mask);
 	if (hash_reset(hash, lock, board, storedata)) return;
+	level = replacement_level(hash_table, hash);
 
 	for (i = 1; i < HASH_N_WAY; ++i) {
 		++hash;
 		if (hash_reset(hash, lock, board, storedata)) return;
-		if (writeable_level(&worst->data) > writeable_level(&hash->data)) {
+		if (level > (l = replacement_level(hash_table, hash))) {
 			worst = hash;
+			level = l;
 		}
 	}
 
@@ -526,6 +596,34 @@ void hash_feed(HashTable *hash_table, const Board *board, const unsigned long lo
 	hash_set(worst, lock, board, storedata);
 }
 
+/**
+ * @brief feed hash table (from Cassio).
+ *
+ * @param hash_table Hash table to update.
+ * @param board Bitboard.
+ * @param hash_code Hash code of an othello board.
+ * @param storedata Data to store.
+ */
+void hash_feed(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata)
+{
+	hash_feed_tier(hash_table, board, hash_code, storedata, 0);
+}
+
+/**
+ * @brief feed hash table with a pv entry (from Cassio).
+ *
+ * The entry is protected from replacement until the next search.
+ *
+ * @param hash_table Hash table to update.
+ * @param board Bitboard.
+ * @param hash_code Hash code of an othello board.
+ * @param storedata Data to store.
+ */
+void hash_feed_pv(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata)
+{
+	hash_feed_tier(hash_table, board, hash_code, storedata, HASH_PV);
+}
+
 /**
  * @brief Store an hashtable item
  *
@@ -554,23 +652,27 @@ void hash_feed(HashTable *hash_table, const Board *board, const unsigned long lo
  * @param storedata.beta       Beta bound when calling the alphabeta function.
  * @param storedata.score      Best score found.
  * @param storedata.move       Best move found.
+ * @param tier HASH_PV for a pv entry, 0 otherwise.
  */
-void hash_store(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata)
+static inline void hash_store_tier(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata, const int tier)
 {
 	int i;
+	unsigned int level, l;
 	Hash *worst, *hash;
 	HashLock *lock;
 
-	worst = hash = hash_table->hash + (hash_code & hash_table->hash_mask);
+	worst = hash = hash_entry(hash_table, hash_code);
 	lock = hash_table->lock + (hash_code & hash_table->lock_mask);
-	storedata->data.wl.c.date = hash_table->date;
+	storedata->data.wl.c.date = hash_table->date | tier;
 	if (hash_update(hash, lock, board, storedata)) return;
+	level = replacement_level(hash_table, hash);
 
 	for (i = 1; i < HASH_N_WAY; ++i) {
 		++hash;
 		if (hash_update(hash, lock, board, storedata)) return;
-		if (writeable_level(&worst->data) > writeable_level(&hash->data)) {
+		if (level > (l = replacement_level(hash_table, hash))) {
 			worst = hash;
+			level = l;
 		}
 	}
 
@@ -578,6 +680,34 @@ void hash_store(HashTable *hash_table, const Board *board, const unsigned long l
 	hash_new(worst, lock, board, storedata);
 }
 
+/**
+ * @brief Store an hashtable item.
+ *
+ * @param hash_table Hash table to update.
+ * @param board Bitboard.
+ * @param hash_code Hash code of an othello board.
+ * @param storedata Data to store.
+ */
+void hash_store(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata)
+{
+	hash_store_tier(hash_table, board, hash_code, storedata, 0);
+}
+
+/**
+ * @brief Store an hashtable item from a PV node.
+ *
+ * The entry is protected from replacement until the next search.
+ *
+ * @param hash_table Hash table to update.
+ * @param board Bitboard.
+ * @param hash_code Hash code of an othello board.
+ * @param storedata Data to store.
+ */
+void hash_store_pv(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata)
+{
+	hash_store_tier(hash_table, board, hash_code, storedata, HASH_PV);
+}
+
 /**
  * @brief Store an hashtable item.
  *
@@ -593,23 +723,27 @@ void hash_store(HashTable *hash_table, const Board *board, const unsigned long l
  * @param storedata.beta       Beta bound when calling the alphabeta function.
  * @param storedata.score      Best score found.
  * @param storedata.move       Best move found.
+ * @param tier HASH_PV for a pv entry, 0 otherwise.
  */
-void hash_force(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata)
+static inline void hash_force_tier(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata, const int tier)
 {
 	int i;
+	unsigned int level, l;
 	Hash *worst, *hash;
 	HashLock *lock;
 
-	worst = hash = hash_table->hash + (hash_code & hash_table->hash_mask);
+	worst = hash = hash_entry(hash_table, hash_code);
 	lock = hash_table->lock + (hash_code & hash_table->lock_mask);
-	storedata->data.wl.c.date = hash_table->date;
+	storedata->data.wl.c.date = hash_table->date | tier;
 	if (hash_replace(hash, lock, board, storedata)) return;
+	level = replacement_level(hash_table, hash);
 
 	for (i = 1; i < HASH_N_WAY; ++i) {
 		++hash;
 		if (hash_replace(hash, lock, board, storedata)) return;
-		if (writeable_level(&worst->data) > writeable_level(&hash->data)) {
+		if (level > (l = replacement_level(hash_table, hash))) {
 			worst = hash;
+			level = l;
 		}
 	}
 
@@ -617,6 +751,34 @@ void hash_force(HashTable *hash_table, const Board *board, const unsigned long l
 	hash_new(worst, lock, board, storedata);
 }
 
+/**
+ * @brief Force the storage of an hashtable item.
+ *
+ * @param hash_table Hash table to update.
+ * @param board Bitboard.
+ * @param hash_code Hash code of an othello board.
+ * @param storedata Data to store.
+ */
+void hash_force(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata)
+{
+	hash_force_tier(hash_table, board, hash_code, storedata, 0);
+}
+
+/**
+ * @brief Force the storage of an hashtable item from a PV node.
+ *
+ * The entry is protected from replacement until the next search.
+ *
+ * @param hash_table Hash table to update.
+ * @param board Bitboard.
+ * @param hash_code Hash code of an othello board.
+ * @param storedata Data to store.
+ */
+void hash_force_pv(HashTable *hash_table, const Board *board, const unsigned long long hash_code, HashStoreData *storedata)
+{
+	hash_force_tier(hash_table, board, hash_code, storedata, HASH_PV);
+}
+
 /**
  * @brief Find an hash table entry according to the evaluated board hash codes.
  *
@@ -635,7 +797,7 @@ bool hash_get(HashTable *hash_table, const Board *board, const unsigned long lon
 
 	HASH_STATS(++statistics.n_hash_search;)
 	HASH_COLLISIONS(++statistics.n_hash_n;)
-	hash = hash_table->hash + (hash_code & hash_table->hash_mask);
+	hash = hash_entry(hash_table, hash_code);
 	for (i = 0; i < HASH_N_WAY; ++i) {
 		HASH_COLLISIONS(if (hash->key == hash_code) {)
 		HASH_COLLISIONS(	lock = hash_table->lock + (hash_code & hash_table->lock_mask);)
@@ -653,8 +815,9 @@ bool hash_get(HashTable *hash_table, const Board *board, const unsigned long lon
 			spin_lock(lock);
 			if (board_equal(&hash->board, board)) {
 				*data = hash->data;
+				data->wl.c.date &= ~HASH_PV;
 				HASH_STATS(++statistics.n_hash_found;)
-				hash->data.wl.c.date = hash_table->date;
+				hash->data.wl.c.date = hash_date(hash->data.wl.c.date, hash_table->date);
 				ok = true;
 			}
 			spin_unlock(lock);
@@ -693,7 +856,7 @@ void hash_exclude_move(HashTable *hash_table, const Board *board, const unsigned
 	Hash *hash;
 	HashLock *lock;
 
-	hash = hash_table->hash + (hash_code & hash_table->hash_mask);
+	hash = hash_entry(hash_table, hash_code);
 	for (i = 0; i < HASH_N_WAY; ++i) {
 		if (board_equal(&hash->board, board)) {
 			lock = hash_table->lock + (hash_code & hash_table->lock_mask);
@@ -722,10 +885,10 @@ void hash_exclude_move(HashTable *hash_table, const Board *board, const unsigned
  */
 void hash_copy(const HashTable *src, HashTable *dest)
 {
-	unsigned int i, imax = src->hash_mask + HASH_N_WAY;
+	unsigned long long i, imax = src->hash_mask + HASH_N_WAY;
 	Hash *pSrc = src->hash, *pDest = dest->hash;
 
-	assert(src->hash_mask == dest->hash_mask);
+	assert(src->hash_mask == dest->hash_mask && src->n_bucket == dest->n_bucket);
 	info("<hash copy>\n");
 	for (i = 0; i <= imax; ++i) {
 		*pDest++ = *pSrc++;
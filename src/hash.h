@@ -19,6 +19,9 @@
 #include <stdbool.h>
 #include <stdio.h>
 
+/** date flag of the entries stored from PV nodes */
+#define HASH_PV 0x80
+
 /** HashData : data stored in the hash table */
 typedef struct HashData {
 	union {
@@ -69,10 +72,12 @@ typedef struct HashTable {
 	void *memory;                 /*!< allocated memory */
 	Hash *hash;                   /*!< hash table */
 	HashLock *lock;               /*!< table with locks */
-	unsigned long long hash_mask; /*!< a bit mask for hash entries */
+	unsigned long long hash_mask; /*!< a bit mask for hash entries (last bucket if n_bucket > 0) */
+	unsigned long long n_bucket;  /*!< bucket number if the size is not a power of 2, 0 otherwise */
 	unsigned int lock_mask;       /*!< a bit mask for lock entries */
-	int n_hash;                   /*!< hash table size */
+	int bucket_size;              /*!< entries between two buckets */
 	int n_lock;                   /*!< number of locks */
+	unsigned long long root;      /*!< occupied squares of the search root */
 	unsigned char date;           /*!< date */
 } HashTable;
 
@@ -91,10 +96,14 @@ void hash_move_init(void);
 void hash_init(HashTable*, const unsigned long long);
 void hash_cleanup(HashTable*);
 void hash_clear(HashTable*);
+void hash_set_root(HashTable*, const Board*);
 void hash_free(HashTable*);
 void hash_feed(HashTable*, const Board *, const unsigned long long, HashStoreData *);
+void hash_feed_pv(HashTable*, const Board *, const unsigned long long, HashStoreData *);
 void hash_store(HashTable*, const Board *, const unsigned long long, HashStoreData *);
+void hash_store_pv(HashTable*, const Board *, const unsigned long long, HashStoreData *);
 void hash_force(HashTable*, const Board *, const unsigned long long, HashStoreData *);
+void hash_force_pv(HashTable*, const Board *, const unsigned long long, HashStoreData *);
 bool hash_get(HashTable*, const Board *, const unsigned long long, HashData *);
 bool hash_get_from_board(HashTable*, const Board *, HashData *);
 void hash_exclude_move(HashTable*, const Board *, const unsigned long long, const int);
@@ -106,8 +115,24 @@ extern const HashData HASH_DATA_INIT;
 extern unsigned long long hash_rank[16][256];
 extern unsigned long long hash_move[64][60];
 
+/**
+ * @brief Get the first entry of a position's bucket.
+ *
+ * Power of 2 tables are indexed by masking the hash code; other tables scale
+ * the upper bits of the hash code to the bucket number.
+ *
+ * @param hash_table Hash table.
+ * @param hash_code Position hash code.
+ * @return The first entry of the bucket.
+ */
+inline Hash* hash_entry(const HashTable *hash_table, const unsigned long long hash_code)
+{
+	if (hash_table->n_bucket == 0) return hash_table->hash + (hash_code & hash_table->hash_mask);
+	return hash_table->hash + ((hash_code >> 32) * hash_table->n_bucket >> 32) * hash_table->bucket_size;
+}
+
 inline void hash_prefetch(HashTable *hashtable, unsigned long long hashcode) {
-	Hash *p = hashtable->hash + (hashcode & hashtable->hash_mask);
+	Hash *p = hash_entry(hashtable, hashcode);
   #ifdef hasSSE2
 	_mm_prefetch((char const *) p, _MM_HINT_T0);
 	_mm_prefetch((char const *)(p + HASH_N_WAY - 1), _MM_HINT_T0);
@@ -51,12 +51,16 @@ void usage(void)
 		" -xboard xboard/winboard protocol.\n"
 		" -nboard NBoard protocol.\n"
 		" -cassio Cassio protocol.\n"
-		" -solve <problem_file>    Automatic problem solver/checker.\n"
+		" -solve <problem_file>... Automatic problem solver/checker.\n"
 		" -wtest <wthor_file>      Test edax using WThor's theoric score.\n"
-		" -count <level>           Count positions up to <level>.\n");
+		" -count <level>           Count positions up to <level>.\n"
+		" -bulk-eval <in> <out>    Evaluate positions at -depth (default 0) into binary scores.\n"
+		" -pipe                    Solve positions read from stdin, one result per line.\n");
 	options_usage();
 }
 
+#ifndef EDAX_HARNESS // harness.c provides its own main
+
 /**
  * @brief edax main function.
  *
@@ -69,10 +73,13 @@ int main(int argc, char **argv)
 {
 	UI *ui;
 	int i, r, level = 0, size = 8;
-	char *problem_file = NULL;
+	char **problem_file = NULL;
+	int n_problem_files = 0, n_fingerprint_diffs = 0;
 	char *wthor_file = NULL;
 	char *count_type = NULL;
+	char *bulk_file[2] = {NULL, NULL};
 	int n_bench = 0;
+	bool pipe_mode = false;
 
 	// options.n_task default to system cpu number
 	options.n_task = get_cpu_number();
@@ -95,9 +102,18 @@ int main(int argc, char **argv)
 		if (strcmp(arg, "v") == 0 || strcmp(arg, "version") == 0) version();
 		else if (ui_switch(ui, arg)) ;
 		else if ((r = (options_read(arg, argv[i + 1]))) > 0) i += r - 1;
-		else if (strcmp(arg, "solve") == 0 && argv[i + 1]) problem_file = argv[++i];
+		else if (strcmp(arg, "solve") == 0 && argv[i + 1]) {
+			problem_file = argv + i + 1;
+			n_problem_files = 0;
+			do ++n_problem_files; while (argv[++i + 1] && *argv[i + 1] != '-');
+		}
 		else if (strcmp(arg, "wtest") == 0 && argv[i + 1]) wthor_file = argv[++i];
 		else if (strcmp(arg, "bench") == 0 && argv[i + 1]) n_bench = atoi(argv[++i]);
+		else if (strcmp(arg, "pipe") == 0) pipe_mode = true;
+		else if (strcmp(arg, "bulk-eval") == 0 && argv[i + 1] && argv[i + 2]) {
+			bulk_file[0] = argv[++i];
+			bulk_file[1] = argv[++i];
+		}
 		else if (strcmp(arg, "count") == 0 && argv[i + 1]) {
 			count_type = argv[++i];
 			if (argv[i + 1]) level = string_to_int(argv[++i], 0);
@@ -122,17 +138,26 @@ int main(int argc, char **argv)
 	search_global_init();
 
 	// solver & tester
-	if (problem_file || wthor_file || n_bench) {
+	if (n_problem_files || wthor_file || n_bench) {
 		Search search;
 		search_init(&search);
 		search.options.header = " depth|score|       time   |  nodes (N)  |   N/s    | principal variation";
 		search.options.separator = "------+-----+--------------+-------------+----------+---------------------";
 		if (options.verbosity) version();
-		if (problem_file) obf_test(&search, problem_file, NULL);
+		for (i = 0; i < n_problem_files; ++i) n_fingerprint_diffs += obf_test(&search, problem_file[i], NULL);
 		if (wthor_file) wthor_test(wthor_file, &search);
 		if (n_bench) obf_speed(&search, n_bench);
 		search_free(&search);
 
+	} else if (pipe_mode) {
+		Search search;
+		search_init(&search);
+		pipe_solve(&search);
+		search_free(&search);
+
+	} else if (bulk_file[0]) {
+		bulk_eval(bulk_file[0], bulk_file[1]);
+
 	} else if (count_type){
 		Board board;
 		board_init(&board);
@@ -161,6 +186,7 @@ int main(int argc, char **argv)
 	options_free();
 	mm_free(ui);
 
-	return 0;
+	return n_fingerprint_diffs ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
+#endif
@@ -12,6 +12,7 @@
 #include "search.h"
 
 #include "bit.h"
+#include "book.h"
 #include "options.h"
 #include "stats.h"
 #include "ybwc.h"
@@ -599,12 +600,12 @@ int NWS_midgame(Search *search, const int alpha, int depth, Node *parent)
 
 	hash_code = board_get_hash_code(&search->board);
 	hash_prefetch(&search->hash_table, hash_code);
-	hash_prefetch(&search->pv_table, hash_code);
+	if (search->book_index && options.book_allowed) book_probe_hash(search, hash_code, false);
 
 	search_get_movelist(search, &movelist);
 
 	// transposition cutoff
-	if (hash_get(&search->hash_table, &search->board, hash_code, &hash_data.data) || hash_get(&search->pv_table, &search->board, hash_code, &hash_data.data))
+	if (hash_get(&search->hash_table, &search->board, hash_code, &hash_data.data))
 		if (search_TC_NWS(&hash_data.data, depth, search->selectivity, alpha, &score)) return score;
 
 	if (movelist_is_empty(&movelist)) { // no moves ?
@@ -660,8 +661,8 @@ int NWS_midgame(Search *search, const int alpha, int depth, Node *parent)
 		hash_data.beta = alpha + 1;
 		hash_data.score = node.bestscore;
 
-		if (search->height <= PV_HASH_HEIGHT) hash_store(&search->pv_table, &search->board, hash_code, &hash_data);
-		hash_store(&search->hash_table, &search->board, hash_code, &hash_data);
+		if (search->height <= PV_HASH_HEIGHT) hash_store_pv(&search->hash_table, &search->board, hash_code, &hash_data);
+		else hash_store(&search->hash_table, &search->board, hash_code, &hash_data);
 
 		SQUARE_STATS(foreach_move(move, &movelist))
 		SQUARE_STATS(++statistics.n_played_square[search->eval.n_empties][SQUARE_TYPE[move->x]];)
@@ -732,6 +733,7 @@ int PVS_midgame(Search *search, const int alpha, const int beta, int depth, Node
 	node_init(&node, search, alpha, beta, depth, movelist.n_moves, parent);
 	node.pv_node = true;
 	hash_code = board_get_hash_code(&search->board);
+	if (search->book_index && options.book_allowed) book_probe_hash(search, hash_code, true);
 
 	// special cases
 	if (movelist_is_empty(&movelist)) {
@@ -750,8 +752,7 @@ int PVS_midgame(Search *search, const int alpha, const int beta, int depth, Node
 	} else { // normal PVS
 		if (movelist.n_moves > 1) {
 			//IID
-			if (!hash_get(&search->pv_table, &search->board, hash_code, &hash_data.data))
-				hash_get(&search->hash_table, &search->board, hash_code, &hash_data.data);
+			hash_get(&search->hash_table, &search->board, hash_code, &hash_data.data);
 
 			if (USE_IID && hash_data.data.move[0] == NOMOVE) {	// (unused)
 				if (depth == search->eval.n_empties) reduced_depth = depth - ITERATIVE_MIN_EMPTIES;
@@ -761,7 +762,7 @@ int PVS_midgame(Search *search, const int alpha, const int beta, int depth, Node
 					depth_pv_extension = search->depth_pv_extension;
 					search->depth_pv_extension = 0;
 					PVS_midgame(search, SCORE_MIN, SCORE_MAX, reduced_depth, parent);
-					hash_get(&search->pv_table, &search->board, hash_code, &hash_data.data);
+					hash_get(&search->hash_table, &search->board, hash_code, &hash_data.data);
 					search->depth_pv_extension = depth_pv_extension;
 					search->selectivity = saved_selectivity;
 				}
@@ -813,8 +814,7 @@ int PVS_midgame(Search *search, const int alpha, const int beta, int depth, Node
 		hash_data.beta = beta;
 		hash_data.score = node.bestscore;
 
-		hash_store(&search->hash_table, &search->board, hash_code, &hash_data);
-		hash_store(&search->pv_table, &search->board, hash_code, &hash_data);
+		hash_store_pv(&search->hash_table, &search->board, hash_code, &hash_data);
 
 		SQUARE_STATS(foreach_move(move, movelist))
 		SQUARE_STATS(++statistics.n_played_square[search->eval.n_empties][SQUARE_TYPE[move->x]];)
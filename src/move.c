@@ -22,8 +22,8 @@
 #include <ctype.h>
 #include <string.h>
 
-const Move MOVE_INIT = {NULL, 0, NOMOVE, -SCORE_INF, 0};
-const Move MOVE_PASS = {NULL, 0, PASS, -SCORE_INF, 0};
+const Move MOVE_INIT = {0, -SCORE_INF, 0, NOMOVE, 0};
+const Move MOVE_PASS = {0, -SCORE_INF, 0, PASS, 0};
 
 const unsigned char SQUARE_VALUE[] = {
 	// JCW's score:
@@ -179,13 +179,13 @@ int movelist_get_moves(MoveList *movelist, const Board *board)
 	n = 0;
 	foreach_bit (x, moves) {
 		move = previous + 1;
-		previous->next = move;
+		previous->next = 1;
 		board_get_move_flip(board, x, move);
 		// move->score = -SCORE_INF;	// -INT_MAX?
 		previous = move;
 		++n;
 	}
-	previous->next = NULL;
+	previous->next = 0;
 	movelist->n_moves = n;
 	return n;
 }
@@ -201,9 +201,9 @@ int movelist_get_moves(MoveList *movelist, const Board *board)
  */
 void movelist_print(const MoveList *movelist, const int player, FILE *f)
 {
-	Move *iter;
+	const Move *iter;
 
-	for (iter = movelist->move[0].next; iter != NULL; iter = iter->next) {
+	for (iter = movelist_first(movelist); iter != NULL; iter = move_next(iter)) {
 		move_print(iter->x, player, f);
 		fprintf(f, "[%d] ", iter->score);
 	}
@@ -220,22 +220,22 @@ __attribute__((noinline))
 #endif
 Move* move_next_best(Move *previous_best)
 {
-	Move *move = previous_best->next;
+	Move *move = move_next(previous_best);
 	if (move && move->next) {	// at least 2 elements
 		Move *best = previous_best;
 		do {
-			if (move->next->score > best->next->score)
+			if (move[move->next].score > best[best->next].score)
 				best = move;
-			move = move->next;
+			move += move->next;
 		} while (move->next);
-		// if (previous_best != best) {
-		move = best->next;
-		best->next = move->next;
-		move->next = previous_best->next;
-		previous_best->next = move;
-		// }
+		if (previous_best != best) {
+			move = best + best->next;
+			move_set_next(best, move_next(move));
+			move_set_next(move, previous_best + previous_best->next);
+			move_set_next(previous_best, move);
+		}
 	}
-	return previous_best->next;
+	return move_next(previous_best);
 }
 
 /**
@@ -246,22 +246,22 @@ Move* move_next_best(Move *previous_best)
  */
 Move* move_next_most_expensive(Move *previous_best)
 {
-	Move *move = previous_best->next;
+	Move *move = move_next(previous_best);
 	if (move && move->next) {	// at least 2 elements
 		Move *best = previous_best;
 		do {
-			if (move->next->cost > best->next->cost)
+			if (move[move->next].cost > best[best->next].cost)
 				best = move;
-			move = move->next;
+			move += move->next;
 		} while (move->next);
-		// if (previous_best != best) {
-		move = best->next;
-		best->next = move->next;
-		move->next = previous_best->next;
-		previous_best->next = move;
-		// }
+		if (previous_best != best) {
+			move = best + best->next;
+			move_set_next(best, move_next(move));
+			move_set_next(move, previous_best + previous_best->next);
+			move_set_next(previous_best, move);
+		}
 	}
-	return previous_best->next;
+	return move_next(previous_best);
 }
 
 #ifdef TUNE_EDAX
@@ -300,12 +300,19 @@ void movelist_evaluate_fast(MoveList *movelist, Search *search, const HashData *
 {
 	Move	*move;
 	int	score, parity_weight;
+#if USE_REGION_PARITY
+	unsigned long long single = 0, odd = 0;
+#endif
 
 	if (search->eval.n_empties < 21)
 		parity_weight = (search->eval.n_empties < 12) ? w_low_parity : w_mid_parity;
 	else	parity_weight = (search->eval.n_empties < 30) ? w_high_parity : 0;
+#if USE_REGION_PARITY
+	if (parity_weight)
+		odd = get_odd_regions(~(search->board.player | search->board.opponent), &single);
+#endif
 
-	move = movelist->move[0].next;
+	move = movelist_first(movelist);
 	do {
 		// move_evaluate(move, search, hash_data, sort_alpha, -1);
 		if (move_wipeout(move, &search->board)) score = (1 << 30);
@@ -338,11 +345,16 @@ void movelist_evaluate_fast(MoveList *movelist, Search *search, const HashData *
   #endif
 #endif
 			score += SQUARE_VALUE[move->x]; // square type
+#if USE_REGION_PARITY
+			if (odd & x_to_bit(move->x))	// region parity
+				score += (single & x_to_bit(move->x)) ? 2 * parity_weight : parity_weight;
+#else
 			score += (search->eval.parity & QUADRANT_ID[move->x]) ? parity_weight : 0; // parity
+#endif
 			SEARCH_UPDATE_ALL_NODES(search->n_nodes);
 		}
 		move->score = score;
-	} while ((move = move->next));
+	} while ((move = move_next(move)));
 }
 
 /**
@@ -404,7 +416,7 @@ void movelist_evaluate(MoveList *movelist, Search *search, const HashData *hash_
 		eval0 = search->eval;
 		sort_alpha = MAX(SCORE_MIN, alpha - SORT_ALPHA_DELTA);
 
-		move = movelist->move[0].next;
+		move = movelist_first(movelist);
 		do {
 			// move_evaluate(move, search, hash_data, sort_alpha, sort_depth);
 			if (move_wipeout(move, &search->board)) score = (1 << 30);
@@ -460,7 +472,7 @@ void movelist_evaluate(MoveList *movelist, Search *search, const HashData *hash_
 				search->board = board0;
 			}
 			move->score = score;
-		} while ((move = move->next));
+		} while ((move = move_next(move)));
 
 	} else	// sort_depth = -1
 		movelist_evaluate_fast(movelist, search, hash_data);
@@ -479,11 +491,11 @@ Move* movelist_sort_bestmove(MoveList *movelist, const int move)
 {
 	Move *iter, *m;
 
-	for (iter = &movelist->move[0]; (m = iter->next); iter = m) {
+	for (iter = &movelist->move[0]; (m = move_next(iter)); iter = m) {
 		if (m->x == move) {
-			iter->next = m->next;
-			m->next = movelist->move[0].next;
-			movelist->move[0].next = m;
+			move_set_next(iter, move_next(m));
+			move_set_next(m, movelist_first(movelist));
+			move_set_next(movelist->move, m);
 			break;
 		}
 	}
@@ -501,25 +513,27 @@ void movelist_sort_cost(MoveList *movelist, const HashData *hash_data)
 	Move *iter, *prev, *m, *hashmove0, *hashmove1;
 
 	hashmove0 = hashmove1 = NULL;
-	for (prev = iter = &movelist->move[0]; (m = prev->next); prev = m) {
+	for (prev = iter = &movelist->move[0]; (m = move_next(prev)); prev = m) {
 		if (m->x == hash_data->move[0])
 			hashmove0 = prev;
 		if (m->x == hash_data->move[1])
 			hashmove1 = prev;
 	}
 	if (hashmove0) {
-		m = hashmove0->next;
-		hashmove0->next = m->next;
-		m->next = iter->next;
+		m = move_next(hashmove0);
+		move_set_next(hashmove0, move_next(m));
+		move_set_next(m, move_next(iter));
 		if (hashmove1 == iter)
 			hashmove1 = m;
-		iter = iter->next = m;
+		move_set_next(iter, m);
+		iter = m;
 	}
 	if (hashmove1) {
-		m = hashmove1->next;
-		hashmove1->next = m->next;
-		m->next = iter->next;
-		iter = iter->next = m;
+		m = move_next(hashmove1);
+		move_set_next(hashmove1, move_next(m));
+		move_set_next(m, move_next(iter));
+		move_set_next(iter, m);
+		iter = m;
 	}
 	while ((iter = move_next_most_expensive(iter)))
 		;
@@ -534,21 +548,21 @@ void movelist_sort(MoveList *movelist)
 	// foreach_best_move(move, *movelist) ;
 
 	Move *previous_best = &movelist->move[0];
-	while (previous_best->next->next) {	// until last 2
+	while (previous_best[previous_best->next].next) {	// until last 2
 		Move *best = previous_best;
-		Move *move = previous_best->next;
+		Move *move = previous_best + previous_best->next;
 		do {
-			if (move->next->score > best->next->score)
+			if (move[move->next].score > best[best->next].score)
 				best = move;
-			move = move->next;
+			move += move->next;
 		} while (move->next);
-		// if (previous_best != best) {
-		move = best->next;
-		best->next = move->next;
-		move->next = previous_best->next;
-		previous_best->next = move;
-		// }
-		previous_best = previous_best->next;
+		if (previous_best != best) {
+			move = best + best->next;
+			move_set_next(best, move_next(move));
+			move_set_next(move, previous_best + previous_best->next);
+			move_set_next(previous_best, move);
+		}
+		previous_best += previous_best->next;
 	}
 }
 
@@ -561,9 +575,9 @@ Move* movelist_exclude(MoveList *movelist, const int move)
 {
 	Move *iter, *m;
 
-	for (iter = &movelist->move[0]; (m = iter->next); iter = m) {
+	for (iter = &movelist->move[0]; (m = move_next(iter)); iter = m) {
 		if (m->x == move) {
-			iter->next = m->next;
+			move_set_next(iter, move_next(m));
 			--movelist->n_moves;
 			break;
 		}
@@ -738,6 +752,16 @@ static bool movearray_append(MoveArray *array, const Board *b, const int x)
 	return true;
 }
 
+/** Number of locks sharding a MoveHash for concurrent appends */
+#define MOVEHASH_N_SHARDS 256
+
+/**
+ * Lock on a subset of the hash table buckets.
+ */
+typedef struct MoveHashShard {
+	SpinLock spin; /**< lock */
+} MoveHashShard;
+
 /**
  * @brief Initialisation of the hash table.
  * @param hash Hash table.
@@ -752,6 +776,9 @@ void movehash_init(MoveHash *hash, int bitsize)
 	hash->array = (MoveArray*) malloc(hash->size * sizeof (MoveArray));
 	if (hash->array == NULL) fatal_error("Cannot re-allocate board array.\n");
 	for (i = 0; i < hash->size; ++i) movearray_init(hash->array + i);
+	hash->shard = (MoveHashShard*) malloc(MOVEHASH_N_SHARDS * sizeof (MoveHashShard));
+	if (hash->shard == NULL) fatal_error("Cannot allocate hash locks.\n");
+	for (i = 0; i < MOVEHASH_N_SHARDS; ++i) spin_init(hash->shard + i);
 }
 
 /**
@@ -764,6 +791,8 @@ void movehash_delete(MoveHash *hash)
 
 	for (i = 0; i < hash->size; ++i) movearray_delete(hash->array + i);
 	free(hash->array);
+	for (i = 0; i < MOVEHASH_N_SHARDS; ++i) spin_free(hash->shard + i);
+	free(hash->shard);
 }
 
 /**
@@ -784,3 +813,28 @@ bool movehash_append(MoveHash *hash, const Board *b, const int x)
 	return movearray_append(hash->array + (h & hash->mask), &u, y);
 }
 
+/**
+ * @brief Append a position to the hash table, from concurrent threads.
+ * @param hash Hash table.
+ * @param b Position.
+ * @param x Move.
+ * @return true if a position is added to the hash table, false otherwsise.
+ */
+bool movehash_append_shared(MoveHash *hash, const Board *b, const int x)
+{
+	Board u;
+	int y;
+	unsigned long long h;
+	MoveHashShard *shard;
+	bool ok;
+
+	y = symetry(x, board_unique(b, &u));
+	h = board_get_hash_code(&u);
+	shard = hash->shard + (h & hash->mask & (MOVEHASH_N_SHARDS - 1));
+	spin_lock(shard);
+	ok = movearray_append(hash->array + (h & hash->mask), &u, y);
+	spin_unlock(shard);
+
+	return ok;
+}
+
@@ -16,13 +16,13 @@
 #include <stdio.h>
 #include <stdbool.h>
 
-/** move representation */
+/** move representation (16 bytes) */
 typedef struct Move {
-	struct Move *next;            /**< next move in a MoveList */
 	unsigned long long flipped;   /**< bitboard representation of flipped squares */
-	int x;                        /**< square played */
 	int score;                    /**< score for this move */
-	unsigned int cost;            /**< move cost */
+	unsigned short cost;          /**< move cost */
+	signed char x;                /**< square played */
+	signed char next;             /**< offset to the next move in a MoveList, 0 for the last one */
 } Move;
 
 /** (simple) list of a legal moves */
@@ -42,6 +42,17 @@ struct Search;
 struct HashData;
 struct Board;
 
+/**
+ * @brief Link a move to the next one of its MoveList.
+ *
+ * @param move Move.
+ * @param next Next move, in the same MoveList, or NULL for the last one.
+ */
+static inline void move_set_next(Move *move, const Move *next)
+{
+	move->next = next ? (signed char) (next - move) : 0;
+}
+
 /* useful constants */
 extern const Move MOVE_INIT;
 extern const Move MOVE_PASS;
@@ -65,7 +76,7 @@ void movelist_evaluate(MoveList*, struct Search*, const struct HashData*, const
 // bool move_wipeout(const Move*, const struct Board*);	// Check if a move wins 64-0.
 #define	move_wipeout(move,board)	((move)->flipped == (board)->opponent)
 // Move* move_next(Move*);	// Return the next move from the list.
-#define move_next(move)	((move)->next)
+#define move_next(move)	((move)->next ? (move) + (move)->next : NULL)
 // Move* movelist_best(MoveList*);	// Return the best move of the list.
 #define	movelist_best(movelist)	move_next_best((movelist)->move)
 // Move* movelist_first(MoveList*);	// Return the first move of the list.
@@ -82,7 +93,7 @@ bool movelist_is_single(const MoveList*);
 
 /** macro to iterate over the movelist */
 #define foreach_move(iter, movelist) \
-	for ((iter) = (movelist).move[0].next; (iter); (iter) = (iter)->next)
+	for ((iter) = movelist_first(&(movelist)); (iter); (iter) = move_next(iter))
 
 /** macro to iterate over the movelist from best to worst move */
 #define foreach_best_move(iter, movelist) \
@@ -99,12 +110,14 @@ char* line_to_string(const Line *line, int n, const char*, char *string);
 /** HashTable of position + move */
 typedef struct MoveHash {
 	struct MoveArray *array;
+	struct MoveHashShard *shard;
 	int size;
 	int mask;
 } MoveHash;
 void movehash_init(MoveHash*, int);
 void movehash_delete(MoveHash*);
 bool movehash_append(MoveHash*, const struct Board*, const int);
+bool movehash_append_shared(MoveHash*, const struct Board*, const int);
 
 #endif
 
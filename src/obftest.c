@@ -21,6 +21,7 @@
 #include "search.h"
 #include "options.h"
 #include "const.h"
+#include "ybwc.h"
 #include "settings.h"
 
 
@@ -272,7 +273,6 @@ static void obf_build(Search *search, OBF *obf, int n)
 		++obf->n_moves;
 
 		hash_code = board_get_hash_code(&search->board);
-		hash_exclude_move(&search->pv_table, &search->board, hash_code, search->result->move);
 		hash_exclude_move(&search->hash_table, &search->board, hash_code, search->result->move);
 		movelist_exclude(&search->movelist, search->result->move);
 	}
@@ -284,21 +284,198 @@ static void obf_build(Search *search, OBF *obf, int n)
 	}
 }
 
+/** Fingerprint of a solved problem */
+typedef struct FingerprintEntry {
+	char *file;                /**<! Problem file */
+	int n;                     /**<! Problem number in the file */
+	unsigned long long n_nodes;/**<! Node count */
+	int score;                 /**<! Score */
+	int move;                  /**<! Best move */
+	long long time;            /**<! Search time (ms) */
+} FingerprintEntry;
+
+/** Fingerprint baseline, recorded by a first run & checked by later runs */
+static struct {
+	FingerprintEntry *entry;   /**<! Baseline entries */
+	int n_entries;             /**<! Number of entries */
+	bool is_open;              /**<! Baseline file already opened */
+	bool is_check;             /**<! Check (true) or record (false) mode */
+} fingerprint = {NULL, 0, false, false};
+
+/**
+ * @brief Open the fingerprint baseline.
+ *
+ * At the first call, an existing baseline file is loaded and checked against;
+ * otherwise a new one is recorded, to which later problem files are appended.
+ *
+ * @param file Baseline file.
+ * @return the file to record to, or NULL when checking.
+ */
+static FILE* fingerprint_open(const char *file)
+{
+	FILE *f;
+	FingerprintEntry e;
+	char *line, name[FILENAME_MAX], move[4];
+
+	if (!fingerprint.is_open) {
+		fingerprint.is_open = true;
+		f = fopen(file, "r");
+		if (f != NULL) {
+			fingerprint.is_check = true;
+			while ((line = string_read_line(f)) != NULL) {
+				if (*line != '#' && sscanf(line, "%s %d %llu %d %3s %lld", name, &e.n, &e.n_nodes, &e.score, move, &e.time) == 6) {
+					fingerprint.entry = (FingerprintEntry*) realloc(fingerprint.entry, (fingerprint.n_entries + 1) * sizeof (FingerprintEntry));
+					if (fingerprint.entry == NULL) fatal_error("Cannot allocate fingerprint entries\n");
+					e.file = string_duplicate(name);
+					e.move = string_to_coordinate(move);
+					fingerprint.entry[fingerprint.n_entries++] = e;
+				}
+				free(line);
+			}
+			fclose(f);
+			printf("fingerprint: checking against %d positions from %s\n", fingerprint.n_entries, file);
+			return NULL;
+		}
+		f = fopen(file, "w");
+		if (f != NULL) fprintf(f, "# problem_file position nodes score move time(ms)\n");
+	} else if (fingerprint.is_check) {
+		return NULL;
+	} else {
+		f = fopen(file, "a");
+	}
+	if (f == NULL) warn("fingerprint: cannot record to %s\n", file);
+
+	return f;
+}
+
+/**
+ * @brief Record the fingerprint of a solved problem.
+ *
+ * @param f Baseline file.
+ * @param obf_file Problem file.
+ * @param n Problem number.
+ * @param search Search.
+ */
+static void fingerprint_record(FILE *f, const char *obf_file, const int n, Search *search)
+{
+	char move[4];
+
+	fprintf(f, "%s %d %llu %d %s %lld\n", obf_file, n, search_count_nodes(search), search->result->score,
+		move_to_string(search->result->move, BLACK, move), search->result->time);
+}
+
+/**
+ * @brief Check a solved problem against its fingerprint.
+ *
+ * Any difference in node count, score or best move is printed.
+ *
+ * @param obf_file Problem file.
+ * @param n Problem number.
+ * @param search Search.
+ * @param baseline_nodes Node count of the baseline (updated).
+ * @param baseline_time Search time of the baseline (updated).
+ * @return 'true' if the fingerprint is identical, 'false' otherwise.
+ */
+static bool fingerprint_check(const char *obf_file, const int n, Search *search, unsigned long long *baseline_nodes, long long *baseline_time)
+{
+	const FingerprintEntry *e;
+	const unsigned long long n_nodes = search_count_nodes(search);
+	char s1[4], s2[4];
+	int i;
+
+	for (i = 0; i < fingerprint.n_entries; ++i) {
+		e = fingerprint.entry + i;
+		if (e->n == n && strcmp(e->file, obf_file) == 0) {
+			*baseline_nodes += e->n_nodes;
+			*baseline_time += e->time;
+			if (e->n_nodes == n_nodes && e->score == search->result->score && e->move == search->result->move) return true;
+			printf("fingerprint: %s #%d: %llu nodes, score %+d, move %s; baseline: %llu nodes, score %+d, move %s\n", obf_file, n,
+				n_nodes, search->result->score, move_to_string(search->result->move, BLACK, s1),
+				e->n_nodes, e->score, move_to_string(e->move, BLACK, s2));
+			return false;
+		}
+	}
+	printf("fingerprint: %s #%d: not in the baseline\n", obf_file, n);
+	return false;
+}
+
+/**
+ * @brief Open & start the performance counters of the search threads.
+ *
+ * The counters of the main thread are opened here; those of the helper
+ * tasks are opened by their own thread, before task_stack_init() returns.
+ *
+ * @param search Search.
+ * @param perf Performance counters of the main thread.
+ */
+static void obf_perf_start(Search *search, PerfCounters *perf)
+{
+	int i;
+
+	if (!options.perf_counters) return;
+
+	if (perf_counters_open(perf) == 0) warn("No hardware performance counter available\n");
+	perf_counters_start(perf);
+	for (i = 1; i < search->tasks->n; ++i) perf_counters_start(&search->tasks->task[i].perf);
+}
+
+/**
+ * @brief Stop & print the performance counters per node, thread by thread.
+ *
+ * Each thread's counts are divided by the total number of nodes, so that the
+ * threads add up to the total.
+ *
+ * @param search Search.
+ * @param perf Performance counters of the main thread.
+ * @param n_nodes Number of searched nodes.
+ */
+static void obf_perf_print(Search *search, PerfCounters *perf, const unsigned long long n_nodes)
+{
+	PerfCounters total;
+	PerfCounters *task_perf;
+	char name[32];
+	int i, j;
+
+	if (!options.perf_counters) return;
+
+	perf_counters_stop(perf);
+	total = *perf;
+	if (n_nodes > 0) {
+		if (search->tasks->n > 1) perf_counters_print(perf, "thread 0", n_nodes, "node", stdout);
+		for (i = 1; i < search->tasks->n; ++i) {
+			task_perf = &search->tasks->task[i].perf;
+			perf_counters_stop(task_perf);
+			for (j = 0; j < PERF_N_COUNTERS; ++j) total.count[j] += task_perf->count[j];
+			snprintf(name, sizeof name, "thread %d", i);
+			perf_counters_print(task_perf, name, n_nodes, "node", stdout);
+		}
+		perf_counters_print(&total, "total", n_nodes, "node", stdout);
+	}
+	perf_counters_close(perf);
+}
+
 /** 
  * @brief Test an OBF file.
+ *
+ * With a fingerprint file, the node count, score & best move of each problem
+ * are recorded to it, or checked against it if it already exists.
+ *
  * @param search Search.
  * @param obf_file OBF file.
  * @param wrong_file OBF file with position wrongly analyzed.
+ * @return the number of problems differing from the fingerprint.
  */
-void obf_test(Search *search, const char *obf_file, const char *wrong_file)
+int obf_test(Search *search, const char *obf_file, const char *wrong_file)
 {
-	FILE *f, *w = NULL;
+	FILE *f, *w = NULL, *fp = NULL;
 	OBF obf;
-	unsigned long long T = 0, n_nodes = 0;
-	int n = 0, n_bad_score = 0, n_bad_move = 0;
+	unsigned long long T = 0, n_nodes = 0, fp_nodes = 0;
+	long long fp_time = 0;
+	int n = 0, n_bad_score = 0, n_bad_move = 0, n_fp_diffs = 0;
 	double score_error = 0.0, move_error = 0.0;
 	int i, ok;
 	bool print_summary = false;
+	PerfCounters perf;
 
 	// add observers
 //	search_cleanup(search);
@@ -320,17 +497,23 @@ void obf_test(Search *search, const char *obf_file, const char *wrong_file)
 		}
 	}
 	
+	if (options.fingerprint_file) fp = fingerprint_open(options.fingerprint_file);
+
 	if (options.verbosity == 1) {
 		if (search->options.header) printf(" # |%s\n", search->options.header);
 		if (search->options.separator) printf("---+%s\n", search->options.separator);
 	}
 
+	obf_perf_start(search, &perf);
+
 	while ((ok = obf_read(&obf, f)) != OBF_PARSE_END) {
 		if (ok == OBF_PARSE_OK) {
 			obf_search(search, &obf, ++n);
 		
-			T += search_time(search);
+			T += search->result->time;
 			n_nodes += search_count_nodes(search);
+			if (fp) fingerprint_record(fp, obf_file, n, search);
+			else if (options.fingerprint_file && fingerprint.is_check && !fingerprint_check(obf_file, n, search, &fp_nodes, &fp_time)) ++n_fp_diffs;
 			for (i = 0; i < obf.n_moves; ++i) {
 				if (obf.move[i].x == search->result->move) break;
 			}
@@ -352,6 +535,17 @@ void obf_test(Search *search, const char *obf_file, const char *wrong_file)
 	time_print(T, false, stdout);
 	if (T > 0 && n_nodes > 0) printf(" (%8.0f nodes/s).", 1000.0 * n_nodes / T);
 	putchar('\n');
+	obf_perf_print(search, &perf, n_nodes);
+
+	if (fp) {
+		printf("fingerprint: %d positions recorded to %s\n", n, options.fingerprint_file);
+		fclose(fp);
+	} else if (options.fingerprint_file && fingerprint.is_check) {
+		printf("fingerprint: %d/%d positions identical", n - n_fp_diffs, n);
+		if (T > 0 && fp_time > 0 && fp_nodes > 0) printf("; %.0f nodes/s, baseline %.0f nodes/s (%+.1f%%)",
+			1000.0 * n_nodes / T, 1000.0 * fp_nodes / fp_time, 100.0 * ((double) n_nodes * fp_time / ((double) fp_nodes * T) - 1.0));
+		putchar('\n');
+	}
 	
 	if (print_summary) {
 		printf("%d positions; ", n);
@@ -365,6 +559,8 @@ void obf_test(Search *search, const char *obf_file, const char *wrong_file)
 
 	fclose(f);
 	if (w) fclose(w);
+
+	return n_fp_diffs;
 }
 
 /** 
@@ -488,6 +684,7 @@ void obf_speed(Search *search, const int n)
 	const int level = options.level;
 	Random r;
 	OBF obf;
+	PerfCounters perf;
 	
 	obf.n_moves = 0;
 	obf.best_score = -SCORE_INF;
@@ -503,12 +700,14 @@ void obf_speed(Search *search, const int n)
 		if (search->options.separator) printf("---+%s\n", search->options.separator);
 	}
 	
+	obf_perf_start(search, &perf);
+
 	for (i = 0; n == - 1 ? real_clock() - t < 60000 : i < n; ++i) {
 		const int ply = MAX(30, 40 - i / 5);
 		obf.player = ply & 1;
 		board_rand(&obf.board, ply, &r);
 		obf_search(search, &obf, i + 1);
-		T += search_time(search);
+		T += search->result->time;
 		n_nodes += search_count_nodes(search);
 	}
 
@@ -518,8 +717,518 @@ void obf_speed(Search *search, const int n)
 	time_print(T, false, stdout);
 	if (T > 0 && n_nodes > 0) printf(" (%8.0f nodes/s).", 1000.0 * n_nodes / T);
 	putchar('\n');
+	obf_perf_print(search, &perf, n_nodes);
 	
 	options.level = level;
 	options.width += 4;
 	
 }
+
+/** Bulk evaluation: number of positions read & evaluated at once */
+#define BULK_CHUNK_SIZE 65536
+
+/** Bulk evaluation: work of a thread */
+typedef struct BulkEval {
+	Search *search;      /**<! Search used by this thread */
+	const Board *board;  /**<! Positions to evaluate */
+	signed char *score;  /**<! Evaluated scores */
+	int n;               /**<! Number of positions */
+	int depth;           /**<! Search depth */
+	Thread thread;       /**<! Running thread */
+} BulkEval;
+
+/**
+ * @brief Create a light search structure for bulk evaluation.
+ *
+ * Unlike search_init, no task stack is created, and the hash tables are
+ * only allocated when needed by PVS_shallow.
+ *
+ * @param depth Search depth.
+ * @return A new search.
+ */
+static Search* bulk_search_create(const int depth)
+{
+	Search *search = (Search*) mm_malloc(sizeof (Search));
+	if (search == NULL) fatal_error("bulk_eval: cannot allocate a search.\n");
+
+	search->hash_table.hash = search->shallow_table.hash = NULL;
+	search->book_index = NULL;
+	if (depth > 2) {
+		hash_init(&search->hash_table, 1 << 16);
+		hash_init(&search->shallow_table, 1 << 16);
+	}
+	search->stop = RUNNING;
+	search->n_nodes = search->child_nodes = 0;
+	search->selectivity = NO_SELECTIVITY;
+	search->probcut_level = 0;
+	search->height = 0;
+	search->node_type[0] = PV_NODE;
+
+	return search;
+}
+
+/**
+ * @brief Free a bulk evaluation search.
+ * @param search Search.
+ */
+static void bulk_search_free(Search *search)
+{
+	if (search->hash_table.hash) hash_free(&search->hash_table);
+	if (search->shallow_table.hash) hash_free(&search->shallow_table);
+	mm_free(search);
+}
+
+/**
+ * @brief Solve a position exactly with a light search.
+ *
+ * Below DEPTH_MIDGAME_TO_ENDGAME empties, the score is narrowed down by null
+ * window searches; with more empties, the moves are searched one ply deeper.
+ *
+ * @param search Light search.
+ * @param alpha Alpha bound.
+ * @param beta Beta bound.
+ * @return The exact score within [alpha, beta], or a bound outside.
+ */
+static int bulk_solve(Search *search, const int alpha, const int beta)
+{
+	int lower, upper, bound, score, bestscore;
+	unsigned int parity0;
+	MoveList movelist;
+	Move *move;
+	const Board board0 = search->board;
+
+	if (search->eval.n_empties < DEPTH_MIDGAME_TO_ENDGAME) {
+		lower = alpha; upper = beta;
+		while (lower < upper) {
+			bound = lower + (upper - lower) / 2;
+			score = NWS_endgame(search, bound);
+			search->board = board0; // the shallow search may return without restoring it
+			if (score > bound) {
+				if (score >= beta) return score;
+				lower = score;
+			} else {
+				if (score <= alpha) return score;
+				upper = score;
+			}
+		}
+		return lower;
+	}
+
+	search_get_movelist(search, &movelist);
+	if (movelist_is_empty(&movelist)) {
+		if (!can_move(search->board.opponent, search->board.player)) return search_solve(search);
+		board_pass(&search->board);
+		score = -bulk_solve(search, -beta, -alpha);
+		board_pass(&search->board);
+		return score;
+	}
+
+	bestscore = -SCORE_INF;
+	parity0 = search->eval.parity;
+	foreach_move (move, movelist) {
+		search->eval.parity = parity0 ^ QUADRANT_ID[move->x];
+		empty_remove(search->empties, move->x);
+		board_update(&search->board, move);
+		--search->eval.n_empties;
+		score = -bulk_solve(search, -beta, -MAX(alpha, bestscore));
+		++search->eval.n_empties;
+		board_restore(&search->board, move);
+		empty_restore(search->empties, move->x);
+		if (score > bestscore) {
+			bestscore = score;
+			if (bestscore >= beta) break;
+		}
+	}
+	search->eval.parity = parity0;
+
+	return bestscore;
+}
+
+/**
+ * @brief Evaluate a position at a fixed depth with a light search.
+ *
+ * Depth 0 is the static evaluation function, depth 1 & 2 use search_eval_1 &
+ * search_eval_2, deeper searches use PVS_shallow. Positions with no more
+ * empties than the depth are solved exactly.
+ *
+ * @param search Light search.
+ * @param board Position to evaluate.
+ * @param depth Search depth.
+ * @return The position score.
+ */
+static int bulk_score(Search *search, const Board *board, const int depth)
+{
+	search->board = *board;
+	search->eval.n_empties = board_count_empties(&search->board);
+
+	if (search->eval.n_empties == 0) return search_solve_0(search);
+
+	if (depth == 0) {
+		eval_set(&search->eval, &search->board);
+		return search_eval_0(search);
+	}
+
+	search_setup(search);
+	if (depth >= search->eval.n_empties) return bulk_solve(search, SCORE_MIN, SCORE_MAX);
+	if (depth == 1) return -search_eval_1(search, SCORE_MIN, SCORE_MAX, board_get_moves(&search->board));
+	if (depth == 2) return search_eval_2(search, SCORE_MIN, SCORE_MAX, board_get_moves(&search->board));
+	return PVS_shallow(search, SCORE_MIN, SCORE_MAX, depth);
+}
+
+/**
+ * @brief Evaluate a slice of positions.
+ *
+ * @param v BulkEval structure.
+ * @return NULL.
+ */
+static void* bulk_eval_run(void *v)
+{
+	BulkEval *bulk = (BulkEval*) v;
+	Search *search = bulk->search;
+	int i;
+
+	for (i = 0; i < bulk->n; ++i) {
+		bulk->score[i] = (signed char) bulk_score(search, bulk->board + i, bulk->depth);
+	}
+
+	return NULL;
+}
+
+/** Fast board parser: character classes */
+enum {
+	PARSE_INVALID,
+	PARSE_SPACE,
+	PARSE_EMPTY,
+	PARSE_BLACK,
+	PARSE_WHITE,
+	PARSE_RUN,
+	PARSE_ROW
+};
+
+/**
+ * @brief Parse a board quickly.
+ *
+ * Unlike parse_board, a single table lookup classifies each character, and
+ * no function is called per square. The board may be written as 64 squares
+ * from A1 (OBF or board string), or in Forsyth-Edwards Notation, from A8 with
+ * digits for runs of empty squares & slashes between rows, 'p' for black &
+ * 'P' for white pieces (as board_to_FEN() writes it), and must be followed by
+ * the player to move.
+ *
+ * @param string String to parse.
+ * @param board Parsed board, from the point of view of the player to move.
+ * @param player Player to move.
+ * @return The remaining of the input string, or the input string on failure.
+ */
+static char* parse_board_fast(const char *string, Board *board, int *player)
+{
+	static const unsigned char class[256] = {
+		[' '] = PARSE_SPACE, ['\t'] = PARSE_SPACE, ['/'] = PARSE_ROW,
+		['-'] = PARSE_EMPTY, ['.'] = PARSE_EMPTY,
+		['b'] = PARSE_BLACK, ['B'] = PARSE_BLACK, ['x'] = PARSE_BLACK, ['X'] = PARSE_BLACK, ['*'] = PARSE_BLACK, ['p'] = PARSE_BLACK,
+		['o'] = PARSE_WHITE, ['O'] = PARSE_WHITE, ['w'] = PARSE_WHITE, ['W'] = PARSE_WHITE, ['P'] = PARSE_WHITE,
+		['1'] = PARSE_RUN, ['2'] = PARSE_RUN, ['3'] = PARSE_RUN, ['4'] = PARSE_RUN,
+		['5'] = PARSE_RUN, ['6'] = PARSE_RUN, ['7'] = PARSE_RUN, ['8'] = PARSE_RUN
+	};
+	const unsigned char *s = (const unsigned char*) string;
+	unsigned long long black = 0, white = 0;
+	int x, n;
+
+	// a FEN board has slashes between its rows, and starts at A8.
+	for (x = 0; s[x] && class[s[x]] != PARSE_SPACE && class[s[x]] != PARSE_ROW; ++x) ;
+	x = (class[s[x]] == PARSE_ROW) ? A8 : A1;
+
+	for (n = 0; n < 64; ++s) {
+		switch (class[*s]) {
+		case PARSE_SPACE:
+			break;
+		case PARSE_ROW:
+			if ((x & 7) || x < 16) return (char*) string;
+			x -= 16;
+			break;
+		case PARSE_EMPTY:
+			++x; ++n;
+			break;
+		case PARSE_BLACK:
+			black |= 1ULL << x++; ++n;
+			break;
+		case PARSE_WHITE:
+			white |= 1ULL << x++; ++n;
+			break;
+		case PARSE_RUN:
+			x += *s - '0'; n += *s - '0';
+			break;
+		default:
+			return (char*) string;
+		}
+		if (x > 64) return (char*) string;
+	}
+	if (n != 64) return (char*) string;
+
+	while (class[*s] == PARSE_SPACE) ++s;
+	if (class[*s] == PARSE_BLACK) {
+		board->player = black;
+		board->opponent = white;
+		*player = BLACK;
+	} else if (class[*s] == PARSE_WHITE) {
+		board->player = white;
+		board->opponent = black;
+		*player = WHITE;
+	} else return (char*) string;
+	board_check(board);
+
+	return (char*) s + 1;
+}
+
+/**
+ * @brief Read a chunk of positions.
+ *
+ * Text files (.obf, .txt) contain a board & the player to move on each line;
+ * other files are read as raw Board records (player to move, opponent).
+ *
+ * @param f Input stream.
+ * @param is_text Text file or not.
+ * @param board Array of boards to fill.
+ * @return Number of boards read.
+ */
+static int bulk_read(FILE *f, const bool is_text, Board *board)
+{
+	char line[256];
+	int n = 0, player;
+
+	if (!is_text) return fread(board, sizeof (Board), BULK_CHUNK_SIZE, f);
+
+	while (n < BULK_CHUNK_SIZE && fgets(line, sizeof line, f)) {
+		const char *s = parse_skip_spaces(line);
+		if (*s == '%' || *s == '\0' || *s == '\n' || *s == '\r') continue;
+		if (parse_board_fast(s, board + n, &player) > s) ++n;
+	}
+	return n;
+}
+
+/**
+ * @brief Evaluate a large set of positions.
+ *
+ * Positions are streamed from the input file by chunks, evaluated at a fixed
+ * depth (the -depth option, 0 by default) by options.n_task threads, each with
+ * its own Search, and the scores written as signed chars to the output file, in
+ * the input order.
+ *
+ * @param input_file File with positions.
+ * @param output_file File with scores.
+ */
+void bulk_eval(const char *input_file, const char *output_file)
+{
+	FILE *in, *out;
+	Board *board;
+	signed char *score;
+	BulkEval bulk[MAX_THREADS];
+	int i, n, n_task, slice, depth;
+	unsigned long long n_positions = 0;
+	long long t;
+	const char *ext = strrchr(input_file, '.');
+	const bool is_text = (ext && (strcmp(ext, ".obf") == 0 || strcmp(ext, ".txt") == 0));
+
+	in = fopen(input_file, is_text ? "r" : "rb");
+	if (in == NULL) {
+		fprintf(stderr, "bulk_eval: cannot open position file %s\n", input_file);
+		exit(EXIT_FAILURE);
+	}
+	out = fopen(output_file, "wb");
+	if (out == NULL) {
+		fprintf(stderr, "bulk_eval: cannot open score file %s\n", output_file);
+		exit(EXIT_FAILURE);
+	}
+
+	board = (Board*) malloc(BULK_CHUNK_SIZE * sizeof (Board));
+	score = (signed char*) malloc(BULK_CHUNK_SIZE);
+	if (board == NULL || score == NULL) fatal_error("bulk_eval: cannot allocate buffers.\n");
+
+	depth = MAX(options.depth, 0);
+	n_task = options.n_task;
+	for (i = 0; i < n_task; ++i) {
+		bulk[i].search = bulk_search_create(depth);
+		bulk[i].depth = depth;
+	}
+
+	t = -real_clock();
+	while ((n = bulk_read(in, is_text, board)) > 0) {
+		slice = (n + n_task - 1) / n_task;
+		for (i = 0; i < n_task; ++i) {
+			bulk[i].board = board + MIN(i * slice, n);
+			bulk[i].score = score + MIN(i * slice, n);
+			bulk[i].n = MIN(slice, n - MIN(i * slice, n));
+		}
+		for (i = 1; i < n_task; ++i) thread_create(&bulk[i].thread, bulk_eval_run, bulk + i);
+		bulk_eval_run(bulk);
+		for (i = 1; i < n_task; ++i) thread_join(bulk[i].thread);
+
+		if (fwrite(score, 1, n, out) != (size_t) n) fatal_error("bulk_eval: cannot write scores.\n");
+		n_positions += n;
+	}
+	t += real_clock();
+
+	printf("%llu positions evaluated at depth %d in ", n_positions, depth);
+	time_print(t, false, stdout);
+	if (t > 0) printf(" (%.0f positions/s)", 1000.0 * n_positions / t);
+	putchar('\n');
+
+	for (i = 0; i < n_task; ++i) bulk_search_free(bulk[i].search);
+	free(board);
+	free(score);
+	fclose(in);
+	fclose(out);
+}
+
+/** Pipe: number of positions buffered between the reader & the solver */
+#define PIPE_QUEUE_SIZE 4096
+
+/** Pipe: a parsed input line */
+typedef struct PipeEntry {
+	Board board;         /**<! Position */
+	int player;          /**<! Player to move */
+	bool ok;             /**<! Successfully parsed */
+} PipeEntry;
+
+/** Pipe: queue of parsed positions */
+typedef struct PipeQueue {
+	PipeEntry entry[PIPE_QUEUE_SIZE]; /**<! Ring buffer */
+	unsigned long long head;          /**<! Number of positions read */
+	unsigned long long tail;          /**<! Number of positions taken */
+	bool end;                         /**<! End of input */
+	Lock lock;                        /**<! Lock */
+	Condition cond;                   /**<! Queue changes */
+} PipeQueue;
+
+/**
+ * @brief Read & parse the positions from the standard input.
+ *
+ * Run by a separate thread, so that parsing overlaps searching.
+ *
+ * @param v Pipe queue.
+ * @return NULL.
+ */
+static void* pipe_read(void *v)
+{
+	PipeQueue *queue = (PipeQueue*) v;
+	PipeEntry entry;
+	char line[256];
+	const char *s;
+	int c;
+
+	while (fgets(line, sizeof line, stdin)) {
+		// a position fits in the buffer: skip the rest of a longer line.
+		if (strchr(line, '\n') == NULL) {
+			while ((c = getchar()) != EOF && c != '\n') ;
+		}
+		s = line;
+		while (*s == ' ' || *s == '\t') ++s;
+		if (*s == '%' || *s == '\0' || *s == '\n' || *s == '\r') continue;
+		entry.ok = (parse_board_fast(s, &entry.board, &entry.player) > s);
+
+		lock(queue);
+			while (queue->head - queue->tail == PIPE_QUEUE_SIZE) condition_wait(queue);
+			queue->entry[queue->head++ % PIPE_QUEUE_SIZE] = entry;
+			if (queue->head - queue->tail == 1) condition_broadcast(queue);
+		unlock(queue);
+	}
+
+	lock(queue);
+		queue->end = true;
+		condition_broadcast(queue);
+	unlock(queue);
+
+	return NULL;
+}
+
+/**
+ * @brief Solve or evaluate a stream of positions.
+ *
+ * Positions (OBF, FEN or board strings, one per line) are read from the
+ * standard input and a compact result line is written to the standard output
+ * for each of them:
+ * <ul>
+ *    <li> with the -depth option, the score of a light fixed-depth search;</li>
+ *    <li> otherwise, the score and best move of a search at -level.</li>
+ * </ul>
+ * Invalid lines produce a "?" line. The output is flushed each time the solver
+ * waits for input. The hash tables are kept between positions.
+ *
+ * @param search Search.
+ */
+void pipe_solve(Search *search)
+{
+	PipeQueue *queue;
+	PipeEntry batch[256];
+	Search *light = NULL;
+	Thread reader;
+	char move[4];
+	int i, n, score;
+	unsigned long long n_positions = 0;
+	long long t = -real_clock();
+
+	queue = (PipeQueue*) malloc(sizeof (PipeQueue));
+	if (queue == NULL) fatal_error("pipe: cannot allocate the position queue.\n");
+	queue->head = queue->tail = 0;
+	queue->end = false;
+	lock_init(queue);
+	condition_init(queue);
+
+	if (options.depth >= 0) light = bulk_search_create(options.depth);
+	search->options.verbosity = 0;
+
+	thread_create(&reader, pipe_read, queue);
+
+	for (;;) {
+		lock(queue);
+			if (queue->head == queue->tail && !queue->end) {
+				unlock(queue);
+				fflush(stdout);
+				lock(queue);
+				while (queue->head == queue->tail && !queue->end) condition_wait(queue);
+			}
+			n = MIN(queue->head - queue->tail, sizeof batch / sizeof batch[0]);
+			for (i = 0; i < n; ++i) batch[i] = queue->entry[(queue->tail + i) % PIPE_QUEUE_SIZE];
+			if (queue->head - queue->tail == PIPE_QUEUE_SIZE) condition_broadcast(queue);
+			queue->tail += n;
+		unlock(queue);
+
+		if (n == 0) break;
+
+		for (i = 0; i < n; ++i) {
+			if (!batch[i].ok) {
+				fputs("?\n", stdout);
+
+			} else if (light) {
+				score = bulk_score(light, &batch[i].board, options.depth);
+				printf("%+d\n", score);
+
+			} else {
+				search_set_board(search, &batch[i].board, batch[i].player);
+				search_set_level(search, options.level, search->eval.n_empties);
+				if (options.selectivity >= 0) search->options.selectivity = options.selectivity;
+				if (options.play_type == EDAX_TIME_PER_MOVE) search_set_move_time(search, options.time);
+				else search_set_game_time(search, options.time);
+				search_run(search);
+				move_to_string(search->result->move, batch[i].player, move);
+				printf("%+d %s\n", search->result->score, move);
+			}
+		}
+		n_positions += n;
+	}
+	fflush(stdout);
+	t += real_clock();
+
+	if (options.verbosity) {
+		fprintf(stderr, "%llu positions in ", n_positions);
+		time_print(t, false, stderr);
+		if (t > 0) fprintf(stderr, " (%.0f positions/s)", 1000.0 * n_positions / t);
+		fputc('\n', stderr);
+	}
+
+	thread_join(reader);
+	if (light) bulk_search_free(light);
+	condition_free(queue);
+	lock_free(queue);
+	free(queue);
+}
@@ -14,10 +14,12 @@
 
 struct Search;
 
-void obf_test(struct Search*, const char*, const char*);
+int obf_test(struct Search*, const char*, const char*);
 void script_to_obf(struct Search*, const char*, const char*);
 void obf_filter(const char*, const char *);
 void obf_speed(struct Search*, const int);
+void bulk_eval(const char*, const char*);
+void pipe_solve(struct Search*);
 
 #endif /* EDAX_OPDTEST_H */
 
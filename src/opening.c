@@ -10,6 +10,8 @@
 
 #include "opening.h"
 #include "board.h"
+#include "game.h"
+#include "util.h"
 
 #include <ctype.h>
 #ifdef UNICODE
@@ -22,7 +24,7 @@ typedef struct OpeningName {
 	const char *name; /**< opening name */
 } OpeningName;
 
-/** reverse opening name */
+/** reverse opening name, tables are sorted by board */
 typedef struct PositionName {
 	Board board;
 	const char *name;
@@ -1268,6 +1270,23 @@ static const PositionName POSITION_NAME[] = {
 	{{0,0}, NULL},
 };
 
+/** size of a normalized opening name */
+#define OPENING_KEY_SIZE 64
+
+/** normalized opening name */
+typedef struct OpeningKey {
+	char key[OPENING_KEY_SIZE]; /**< name without accent, case, space & punctuation */
+	int length;                 /**< key length */
+	int rank;                   /**< rank in OPENING_NAME */
+} OpeningKey;
+
+/** index of the opening names */
+static struct {
+	OpeningKey *key;            /**< keys sorted by name, then rank */
+	int n_keys;                 /**< key number */
+	int max_discs;              /**< disc number of the most advanced named position */
+} opening_index;
+
 /**
  * Normalize a char, ignoring accents and font case.
  *
@@ -1291,58 +1310,163 @@ static int to_lower_no_accent(int c)
 }
 
 /**
- * Compare two string, ignoring accents, font case, etc.
+ * Read the next char of a string, ignoring accents, font case, etc.
  *
- * @param s1 first string.
- * @param s2 second string.
+ * @param s string, advanced past the read char.
+ * @return the normalized char, or 0 at the end of the string.
  */
-static bool match(const char *s1, const char *s2)
+static int next_char(const char **s)
 {
-	int c1, c2;
-
-	for (;;) {
-		while (isspace(*s1) || ispunct(*s1)) ++s1;
-		while (isspace(*s2) || ispunct(*s2)) ++s2;
+	int c;
 
-		if (*s1 == '\0' || *s2 == '\0') return (*s2 == '\0');
+	while (isspace(**s) || ispunct(**s)) ++*s;
+	if (**s == '\0') return 0;
 
-		c1 = *s1++;
-		c2 = *s2++;
+	c = *(*s)++;
 #ifdef UNICODE
-		if ("ê"[0] == '\xc3') {	// test source encoding
-			if (c1 & 0x80) {	// utf8 to UCS2
-				c1 &= 0x1f;
-				while ((*s1 & 0xc0) == 0x80)
-					c1 = (c1 << 6) | (*s1++ & 0x3f);
-			}
-			if (c2 & 0x80) {
-				c2 &= 0x1f;
-				while ((*s2 & 0xc0) == 0x80)
-					c2 = (c2 << 6) | (*s2++ & 0x3f);
-			}
+	if ("ê"[0] == '\xc3') {	// test source encoding
+		if (c & 0x80) {	// utf8 to UCS2
+			c &= 0x1f;
+			while ((**s & 0xc0) == 0x80)
+				c = (c << 6) | (*(*s)++ & 0x3f);
 		}
+	}
 #endif
-		c1 = to_lower_no_accent(c1);
-		c2 = to_lower_no_accent(c2);
+	return to_lower_no_accent(c);
+}
+
+/**
+ * Normalize a string, ignoring accents, font case, etc.
+ *
+ * Normalized chars are utf8-encoded, so that two strings match if and only if
+ * their normalized keys are equal.
+ *
+ * @param s string.
+ * @param key output normalized string.
+ * @return key length.
+ */
+static int normalize(const char *s, char *key)
+{
+	int c, n = 0;
+
+	while ((c = next_char(&s)) != 0 && n < OPENING_KEY_SIZE - 4) {
+		if (c < 0x80) {
+			key[n++] = c;
+		} else if (c < 0x800) {
+			key[n++] = 0xc0 | (c >> 6);
+			key[n++] = 0x80 | (c & 0x3f);
+		} else {
+			key[n++] = 0xe0 | ((c >> 12) & 0x0f);
+			key[n++] = 0x80 | ((c >> 6) & 0x3f);
+			key[n++] = 0x80 | (c & 0x3f);
+		}
+	}
+	key[n] = '\0';
+
+	return n;
+}
+
+/**
+ * Compare two opening keys, by name then by rank.
+ *
+ * @param a first key.
+ * @param b second key.
+ * @return -1, 0 or 1 as a < b, a = b or a > b.
+ */
+static int opening_key_compare(const void *a, const void *b)
+{
+	const OpeningKey *k1 = (const OpeningKey*) a;
+	const OpeningKey *k2 = (const OpeningKey*) b;
+	const int c = strcmp(k1->key, k2->key);
+
+	if (c) return c;
+	return (k1->rank > k2->rank) - (k1->rank < k2->rank);
+}
 
-		if (c1 != c2) return false;
+/**
+ * Build the opening name index, once.
+ */
+static void opening_index_init(void)
+{
+	const PositionName *p;
+	int i, n;
+
+	if (opening_index.key != NULL) return;
+
+	for (n = 0; OPENING_NAME[n].name != NULL; ++n) ;
+	opening_index.key = (OpeningKey*) malloc(n * sizeof (OpeningKey));
+	if (opening_index.key == NULL) fatal_error("opening_index_init: cannot allocate the index\n");
+
+	for (i = 0; i < n; ++i) {
+		opening_index.key[i].length = normalize(OPENING_NAME[i].name, opening_index.key[i].key);
+		opening_index.key[i].rank = i;
 	}
+	qsort(opening_index.key, n, sizeof (OpeningKey), opening_key_compare);
+	opening_index.n_keys = n;
+
+	for (p = POSITION_NAME; p->name != NULL; ++p) opening_index.max_discs = MAX(opening_index.max_discs, bit_count(p->board.player | p->board.opponent));
+	for (p = NOM_POSITION; p->name != NULL; ++p) opening_index.max_discs = MAX(opening_index.max_discs, bit_count(p->board.player | p->board.opponent));
 }
 
 /**
  * @brief Translate an opening name into its move sequence.
  *
+ * Any opening name prefixing the normalized input matches; as with a scan of
+ * the OPENING_NAME table, the first one in the table wins.
+ *
  * @param opening_name An opening name (in lowercase).
  * @return A move sequence.
  */
 const char *opening_get_line(const char *opening_name)
 {
-	const OpeningName *o;
+	OpeningKey input;
+	int l, low, high, mid, best = -1;
+
+	opening_index_init();
+	input.length = normalize(opening_name, input.key);
+	input.rank = -1;
+
+	// binary search of each prefix of the input
+	for (l = 1; l <= input.length; ++l) {
+		const char c = input.key[l];
+		input.key[l] = '\0';
+		for (low = 0, high = opening_index.n_keys; low < high;) {
+			mid = (low + high) / 2;
+			if (opening_key_compare(opening_index.key + mid, &input) < 0) low = mid + 1;
+			else high = mid;
+		}
+		if (low < opening_index.n_keys && opening_index.key[low].length == l && strcmp(opening_index.key[low].key, input.key) == 0) {
+			if (best < 0 || opening_index.key[low].rank < best) best = opening_index.key[low].rank;
+		}
+		input.key[l] = c;
+	}
+
+	return best < 0 ? NULL : OPENING_NAME[best].line;
+}
+
+/**
+ * @brief Find a normalized board in a position table.
+ *
+ * Position tables are sorted by board, so they are binary searched.
+ *
+ * @param table Position table.
+ * @param n Table size.
+ * @param unique Normalized board.
+ * return An opening name, or NULL if none has been found.
+ */
+static const char *position_find(const PositionName *table, const int n, const Board *unique)
+{
+	int low = 0, high = n, mid;
 
-	for (o = OPENING_NAME; o->name != NULL; ++o) {
-		if (match(opening_name, o->name)) break;
+	while (low < high) {
+		mid = (low + high) / 2;
+		if (table[mid].board.player < unique->player
+		|| (table[mid].board.player == unique->player && table[mid].board.opponent < unique->opponent)) low = mid + 1;
+		else high = mid;
 	}
-	return o->line;
+
+	if (low < n && board_equal(&table[low].board, unique)) return table[low].name;
+	return NULL;
 }
 
 /**
@@ -1353,15 +1477,10 @@ const char *opening_get_line(const char *opening_name)
  */
 const char *opening_get_english_name(const Board *board)
 {
-	const PositionName *p;
 	Board unique;
 
 	board_unique(board, &unique);
-	for (p = POSITION_NAME; p->name != NULL; ++p) {
-		if (board_equal(&unique, &p->board)) break;
-	}
-
-	return p->name;
+	return position_find(POSITION_NAME, (sizeof POSITION_NAME / sizeof POSITION_NAME[0]) - 1, &unique);
 }
 
 /**
@@ -1372,13 +1491,37 @@ const char *opening_get_english_name(const Board *board)
  */
 const char *opening_get_french_name(const Board *board)
 {
-	const PositionName *p;
 	Board unique;
 
 	board_unique(board, &unique);
-	for (p = NOM_POSITION; p->name != NULL; ++p) {
-		if (board_equal(&unique, &p->board)) break;
-	}
+	return position_find(NOM_POSITION, (sizeof NOM_POSITION / sizeof NOM_POSITION[0]) - 1, &unique);
+}
 
-	return p->name;
+/**
+ * @brief Find the english & french names of the opening of a game.
+ *
+ * The game is replayed until its position has more discs than any named one;
+ * the names of the most advanced named positions are kept.
+ *
+ * @param game Game.
+ * @param english Output english name, or NULL if none has been found.
+ * @param french Output french name, or NULL if none has been found.
+ */
+void opening_get_game_names(const Game *game, const char **english, const char **french)
+{
+	Board board, unique;
+	const char *name;
+	int i;
+
+	opening_index_init();
+	*english = *french = NULL;
+
+	board = game->initial_board;
+	for (i = 0; i < 60 && game->move[i] != NOMOVE; ++i) {
+		if (!game_update_board(&board, game->move[i])) break;
+		if (bit_count(board.player | board.opponent) > opening_index.max_discs) break;
+		board_unique(&board, &unique);
+		if ((name = position_find(POSITION_NAME, (sizeof POSITION_NAME / sizeof POSITION_NAME[0]) - 1, &unique)) != NULL) *english = name;
+		if ((name = position_find(NOM_POSITION, (sizeof NOM_POSITION / sizeof NOM_POSITION[0]) - 1, &unique)) != NULL) *french = name;
+	}
 }
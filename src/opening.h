@@ -12,10 +12,12 @@
 #define EDAX_OPENING_NAME
 
 struct Board;
+struct Game;
 
 const char *opening_get_line(const char*);
 const char *opening_get_french_name(const struct Board*);
 const char *opening_get_english_name(const struct Board*);
+void opening_get_game_names(const struct Game*, const char**, const char**);
 
 #endif
 
@@ -21,6 +21,7 @@
 /** global options with default value */
 Options options = {
 	21, // hash table size (2^21 * 24 * 2.0625 = 104MB)
+	0, // memory budget (none)
 
 	{0,-2,-3}, // inc_sort_depth
 
@@ -32,6 +33,7 @@ Options options = {
 	80, // width
 	false, // echo
 	false, // info
+	false, // perf counters
 	false, // debug cassio
 	true, // transgress cassio
 
@@ -46,6 +48,7 @@ Options options = {
 
 	10000000,  // speed (default = 10e6)
 	0,         // nps (default = 0)
+	0,         // nodes (default = 0)
 
 	SCORE_MIN, // alpha
 	SCORE_MAX, // beta
@@ -70,6 +73,7 @@ Options options = {
 	false, // pv guess
 
 	NULL, // game file.
+	NULL, // fingerprint file.
 
 	NULL, // search log file.
 	NULL, // ui log file.
@@ -100,8 +104,10 @@ void options_usage(void)
 		"  -noise <n>                    noise level (print search output from ply <n>).\n"
 		"  -width <n>                    line width.\n"
 		"  -h|hash-table-size <nbits>    hash table size.\n"
+		"  -memory <size>                memory budget (eg 512M, 2G) shared by the hash tables.\n"
 		"  -n|n-tasks <n>                search in parallel using n tasks.\n"
 		"  -cpu                          search using 1 cpu/thread.\n"
+		"  -perf-counters                report hardware performance counters of tests & benchmarks.\n"
 #ifdef __APPLE__
 		"\nCassio protocol options:\n"
 		"  -debug-cassio                 print extra-information in cassio.\n"
@@ -111,6 +117,7 @@ void options_usage(void)
 		"  -l|level <n>                  search using limited depth.\n"
 		"  -t|game-time <n>              search using limited time per game.\n"
 		"  -move-time <n>                search using limited time per move.\n"
+		"  -nodes <n>                    stop each search after n nodes.\n"
 		"  -ponder <on/off>              search during opponent time.\n"
 		"  -eval-file                    read eval weight from this file.\n"
 		"  -book-file                    load opening book from this file.\n"
@@ -120,6 +127,7 @@ void options_usage(void)
 		"  -auto-swap <on/off>           automatically Edax's color between games\n"
 		"  -auto-store <on/off>          automatically save played games\n"
 		"  -game-file <file>             file to store all played game/s.\n"
+		"  -fingerprint <file>           record, or check against, the node counts, scores & moves of solved problems.\n"
 		"  -search-log-file <file>       file to store search detailed output/s.\n"
 		"  -ui-log-file <file>           file to store input/output to the (U)ser (I)nterface.\n");
 
@@ -149,6 +157,7 @@ int options_read(const char *option, const char *value)
 	else if (strcmp(option, "follow-cassio") == 0) options.transgress_cassio = false;
 	else if (strcmp(option, "?") == 0 || strcmp(option, "help") == 0) usage();
 	else if (strcmp(option, "cpu") == 0) options.cpu_affinity = true;
+	else if (strcmp(option, "perf-counters") == 0) options.perf_counters = true;
 	else {
 		read = 0;
 		if (value == NULL || *value == '\0') return read;
@@ -158,6 +167,7 @@ int options_read(const char *option, const char *value)
 		else if (strcmp(option, "width") == 0) options.width = string_to_int(value, options.width);
 
 		else if (strcmp(option, "h") == 0  || strcmp(option, "hash-table-size") == 0) options.hash_table_size = string_to_int(value, options.hash_table_size);
+		else if (strcmp(option, "memory") == 0) options.memory = string_to_size(value);
 		else if (strcmp(option, "n") == 0 || strcmp(option, "n-tasks") == 0) options.n_task = string_to_int(value, options.n_task);
 		else if (strcmp(option, "l") == 0 || strcmp(option, "level") == 0) {
 			options.level = string_to_int(value, options.level);
@@ -181,6 +191,7 @@ int options_read(const char *option, const char *value)
 		else if (strcmp(option, "o") == 0 || strcmp(option, "option-file") == 0) options_parse(value);
 		else if (strcmp(option, "speed") == 0) options.speed = string_to_real(value, options.speed);
 		else if (strcmp(option, "nps") == 0) options.nps = 0.001 * string_to_real(value, options.nps);
+		else if (strcmp(option, "nodes") == 0) options.nodes = (unsigned long long) MAX(string_to_real(value, 0), 0);
 		else if (strcmp(option, "ponder") == 0) parse_boolean(value, &options.can_ponder);
 		else if (strcmp(option, "mode") == 0) parse_int(value, &options.mode);
 
@@ -201,6 +212,7 @@ int options_read(const char *option, const char *value)
 		else if (strcmp(option, "pv-guess") == 0) parse_boolean(value, &options.pv_guess);
 
 		else if (strcmp(option, "game-file") == 0) options.game_file = string_duplicate(value);
+		else if (strcmp(option, "fingerprint") == 0) options.fingerprint_file = string_duplicate(value);
 
 		else if (strcmp(option, "eval-file") == 0) options.eval_file = string_duplicate(value);	// 11/13/2015
 
@@ -338,13 +350,15 @@ void options_dump(FILE *f)
 	fprintf(f, "\tminimal depth (noise): %d\n", options.noise);
 	fprintf(f, "\tline width: %d\n", options.width);
 	fprintf(f, "\tuser input echo: %s\n", boolean_string[options.echo]);
-	fprintf(f, "\t<detailed info>: %s\n\n", boolean_string[options.info]);
+	fprintf(f, "\t<detailed info>: %s\n", boolean_string[options.info]);
+	fprintf(f, "\tperformance counters: %s\n\n", boolean_string[options.perf_counters]);
 	fprintf(f, "Cassio options\n");
 	fprintf(f, "\tdisplay debug info in Cassio's 'fenetre de rapport': %s\n", boolean_string[options.debug_cassio]);
 	fprintf(f, "\tadapt Cassio requests to search & solve faster: %s\n\n", boolean_string[options.transgress_cassio]);
 
 	fprintf(f, "\tsearch options\n");
 	fprintf(f, "\tsize (in number of bits) of the hash table: %d\n", options.hash_table_size);
+	if (options.memory) fprintf(f, "\tmemory budget: %llu bytes\n", options.memory);
 	fprintf(f, "\tsorting depth increment: pv = %d, all = %d, cut = %d\n",  options.inc_sort_depth[0], options.inc_sort_depth[1], options.inc_sort_depth[2]);
 	fprintf(f, "\ttask number for parallel search: %d\n", options.n_task);
 	fprintf(f, "\tsearch level: %d\n", options.level);
@@ -355,6 +369,7 @@ void options_dump(FILE *f)
 	fprintf(f, "\tsearch selectivity: %d\n", options.selectivity);
 	fprintf(f, "\tsearch speed %.0f N/s\n", options.speed);
 	fprintf(f, "\tsearch nps %.0f N/s\n", options.nps);
+	if (options.nodes) fprintf(f, "\tsearch node budget: %llu\n", options.nodes);
 	fprintf(f, "\tsearch alpha: %d\n", options.alpha);
 	fprintf(f, "\tsearch beta: %d\n", options.beta);
 	fprintf(f, "\tsearch all best moves: %s\n", boolean_string[options.all_best]);
@@ -376,6 +391,7 @@ void options_dump(FILE *f)
 	fprintf(f, "\tguess: %s\n\n", boolean_string[options.pv_guess]);
 
 	fprintf(f, "game file: %s\n", options.game_file ? options.game_file : "?");
+	fprintf(f, "fingerprint file: %s\n", options.fingerprint_file ? options.fingerprint_file : "?");
 
 	fprintf(f, "log files\n");
 	fprintf(f, "\tsearch: %s\n", options.search_log_file ? options.search_log_file : "?");
@@ -404,6 +420,7 @@ void options_free(void)
 	free(options.ggs_port);
 
 	free(options.game_file);
+	free(options.fingerprint_file);
 	free(options.ui_log_file);
 	free(options.search_log_file);
 	free(options.ggs_log_file);
@@ -23,6 +23,7 @@ typedef enum {
 /** options to control various heuristics */
 typedef struct {
 	int hash_table_size;                  /**< size (in number of bits) of the hash table */
+	unsigned long long memory;            /**< memory budget in bytes (0 = use hash_table_size) */
 
 	int inc_sort_depth[3];                /**< increment sorting depth */
 
@@ -34,6 +35,7 @@ typedef struct {
 	int width;                            /**< line width */
 	bool echo;                            /**< repeat user input */
 	bool info;                            /**< info display */
+	bool perf_counters;                   /**< report hardware performance counters */
 	bool debug_cassio;                    /**< display debug info in cassio's "fenetre de rapport"*/
 	bool transgress_cassio;               /**< adapt Cassio requests to search & solve faster */
 
@@ -48,6 +50,7 @@ typedef struct {
 
 	double speed;                         /**< edax speed in N/S (for a more accurate time management) */
 	double nps;                           /**< edax assumed speed (for nps based timing */                           
+	unsigned long long nodes;             /**< node budget of a search (0 = no limit) */
 
 	int alpha;                            /**< alpha bound */
 	int beta;                             /**< beta bound */
@@ -73,6 +76,7 @@ typedef struct {
 	bool pv_guess;                        /**< guess PV missing moves */
 
 	char *game_file;                      /**< game file */
+	char *fingerprint_file;               /**< per-problem node counts, scores & moves to record or check */
 
 	char *search_log_file;                /**< log file (for search) */
 	char *ui_log_file;                    /**< log file (for user interface) */
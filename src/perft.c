@@ -19,6 +19,7 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 
 /**
  * Gathered statistiscs
@@ -168,60 +169,162 @@ static void estimate_game(const Board *board, const int depth, Random *r, double
 	}
 }
 
+/** Number of random games per thread between two convergence checks */
+#define ESTIMATE_BATCH 10000
+
+/** Number of standard errors of a 95% confidence interval */
+#define ESTIMATE_Z 1.96
+
+/**
+ * Sums gathered by random games.
+ */
+typedef struct EstimateStats {
+	double m[128];  /*< sum of node counts per ply */
+	double s[128];  /*< sum of squared node counts per ply */
+	double em[128]; /*< sum of game counts per ply */
+	double es[128]; /*< sum of squared game counts per ply */
+	double en[128]; /*< number of games ending at each ply */
+	double M, S;    /*< sum & sum of squares of the total node count */
+	double EM, ES;  /*< sum & sum of squares of the total game count */
+} EstimateStats;
+
+/**
+ * A thread playing random games.
+ */
+typedef struct EstimateTask {
+	Thread thread;       /*< thread */
+	const Board *board;  /*< root board */
+	Random r;            /*< random generator, with its own seed */
+	long long n;         /*< number of games to play */
+	EstimateStats stats; /*< gathered sums */
+} EstimateTask;
+
+/**
+ * @brief Play random games & gather their statistics.
+ *
+ * @param v Estimate task.
+ * @return NULL.
+ */
+static void* estimate_task(void *v)
+{
+	EstimateTask *task = (EstimateTask*) v;
+	EstimateStats *stats = &task->stats;
+	double x[128];
+	long long j;
+	int i;
+
+	for (j = 0; j < task->n; ++j) {
+		for (i = 0; i < 128; ++i) x[i] = 0.0;
+		estimate_game(task->board, 1, &task->r, x);
+		for (i = 1; x[i]; ++i) {
+			stats->m[i] += x[i]; stats->s[i] += x[i] * x[i];
+			stats->M += x[i]; stats->S += x[i] * x[i];
+		}
+		stats->em[i] += x[i - 1]; stats->es[i] += x[i - 1] * x[i - 1];
+		stats->EM += x[i - 1]; stats->ES += x[i - 1] * x[i - 1];
+		stats->en[i]++;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Half width of a 95% confidence interval of a mean.
+ *
+ * @param sum Sum of the samples.
+ * @param sum2 Sum of the squared samples.
+ * @param n Number of samples.
+ * @param mean Mean (output).
+ * @return the half width.
+ */
+static double estimate_interval(const double sum, const double sum2, const double n, double *mean)
+{
+	const double m = sum / n;
+	const double v = sum2 / n - m * m;
+
+	*mean = m;
+	return ESTIMATE_Z * sqrt((v > 0.0 ? v : 0.0) / n);
+}
+
 /**
  * @brief Move estimate games
  *
+ * Random games are played by options.n_task threads, each with its own random
+ * generator. Estimates are printed with their 95% confidence interval.
+ *
  * @param board
  * @param n Number of trials
+ * @param max_error Stop once the relative error of the totals is below this value (0 = never).
  */
-void estimate_games(const Board *board, const long long n)
+void estimate_games(const Board *board, const long long n, const double max_error)
 {
-	int i, j;
-	unsigned long long t;
-	double x[128], m[128], s[128], em[128], es[128], en[128];
-	double M, S, EM, ES;
+	int i, k;
+	long long t, n_done, remaining;
+	EstimateTask *task;
+	EstimateStats stats;
+	double m, e, em, ee, M, E, EM, EE;
+	const int n_task = options.n_task;
 	Random r;
 
-	t = -cpu_clock();
+	task = (EstimateTask*) malloc(n_task * sizeof (EstimateTask));
+	if (task == NULL) fatal_error("estimate_games: cannot allocate the tasks.\n");
+	memset(task, 0, n_task * sizeof (EstimateTask));
 	random_seed(&r, real_clock());
-	M = S = EM = ES = 0.0;
-	for (i = 0; i < 128; ++i) m[i] = s[i] = 0.0;
-	for (i = 0; i < 128; ++i) em[i] = es[i] = en[i] = 0.0;
+	for (k = 0; k < n_task; ++k) {
+		task[k].board = board;
+		random_seed(&task[k].r, random_get(&r));
+	}
 
+	memset(&stats, 0, sizeof stats);
 	board_print(board, BLACK, stdout);
-	for (j = 1; j <= n; ++j) {
-		for (i = 0; i < 128; ++i) x[i] = 0.0;
-		estimate_game(board, 1, &r, x);
-		for (i = 1; x[i]; ++i) {
-			m[i] += x[i]; s[i] += x[i] * x[i];
-			M += x[i]; S += x[i] * x[i];
+	t = -real_clock();
+	for (n_done = 0; n_done < n; ) {
+		remaining = n - n_done;
+		for (k = 0; k < n_task; ++k) task[k].n = MIN(ESTIMATE_BATCH, remaining / n_task + (k < remaining % n_task));
+		for (k = 1; k < n_task; ++k) thread_create(&task[k].thread, estimate_task, task + k);
+		estimate_task(task);
+		for (k = 1; k < n_task; ++k) thread_join(task[k].thread);
+
+		memset(&stats, 0, sizeof stats);
+		for (k = 0; k < n_task; ++k) {
+			n_done += task[k].n;
+			for (i = 0; i < 128; ++i) {
+				stats.m[i] += task[k].stats.m[i]; stats.s[i] += task[k].stats.s[i];
+				stats.em[i] += task[k].stats.em[i]; stats.es[i] += task[k].stats.es[i];
+				stats.en[i] += task[k].stats.en[i];
+			}
+			stats.M += task[k].stats.M; stats.S += task[k].stats.S;
+			stats.EM += task[k].stats.EM; stats.ES += task[k].stats.ES;
 		}
-		{
-			em[i] += x[i - 1]; es[i] += x[i - 1] * x[i - 1];
-			EM += x[i - 1]; ES += x[i - 1] * x[i - 1];
-			en[i]++;
-		} 
-	}	
-	t += cpu_clock();
-
-	for (i = 1; m[i] || en[i]; ++i) {
-		m[i] /= n;
-		s[i] = sqrt((s[i] / n - m[i] * m[i])/n);
-		printf("%2d: %e +/- %e; ", i, m[i], s[i]);
-
-		if (en[i]) {
-			em[i] /= n;
-			es[i] = sqrt((es[i] / n - em[i] * em[i])/n);
-			printf("%e +/- %e;", em[i], es[i]);
+
+		if (max_error > 0.0 && n_done > 1) {
+			E = estimate_interval(stats.M, stats.S, n_done, &M);
+			EE = estimate_interval(stats.EM, stats.ES, n_done, &EM);
+			if (E <= max_error * M && EE <= max_error * EM) break;
+		}
+	}
+	t += real_clock();
+
+	printf("ply: moves +/- 95%% interval; games +/- 95%% interval\n");
+	for (i = 1; stats.m[i] || stats.en[i]; ++i) {
+		e = estimate_interval(stats.m[i], stats.s[i], n_done, &m);
+		printf("%2d: %e +/- %e; ", i, m, e);
+
+		if (stats.en[i]) {
+			ee = estimate_interval(stats.em[i], stats.es[i], n_done, &em);
+			printf("%e +/- %e;", em, ee);
 		}
 		putchar('\n');
 	}
-	M /= n;
-	S = sqrt((S / n - M * M)/n);
-	EM /= n;
-	ES = sqrt((ES / n - EM * EM)/n);
-	printf("Total %e +/- %e: %e +/- %e en", M, S, EM, ES);
-	time_print(t, false, stdout); printf("\n");
+	E = estimate_interval(stats.M, stats.S, n_done, &M);
+	EE = estimate_interval(stats.EM, stats.ES, n_done, &EM);
+	printf("Total %e +/- %e (%.2f%%): %e +/- %e (%.2f%%) en ", M, E, 100.0 * E / M, EM, EE, 100.0 * EE / EM);
+	time_print(t, false, stdout);
+	printf(" (%lld games", n_done);
+	if (t > 0) printf(", %.0f games/s", 1000.0 * n_done / t);
+	printf(")\n");
+
+	free(task);
 }
 
 /**
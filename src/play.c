@@ -454,7 +454,7 @@ void* play_ponder_run(void *v)
 		board = play->board;
 		player = play->player;
 		search_set_game_time(search, TIME_MAX);
-		search->options.keep_date = (play->state == IS_PONDERING && search->pv_table.date > 0);
+		search->options.keep_date = (play->state == IS_PONDERING && search->hash_table.date > 0);
 		if (play->ponder.verbose) search->options.verbosity = options.verbosity;
 		else search->options.verbosity = 0;
 
@@ -709,7 +709,6 @@ static int play_alternative(Play *play, Move *played, Move *alternative, int *de
 	if (A1 <= played->x && played->x <= H8) {
 		movelist_exclude(&search->movelist, played->x);
 		hash_code = board_get_hash_code(&search->board);
-		hash_exclude_move(&search->pv_table, &search->board, hash_code, played->x);
 		hash_exclude_move(&search->hash_table, &search->board, hash_code, played->x);
 		// also remove moves leading to symetrical positions
 		board_next(&play->board, played->x, &board);
@@ -719,7 +718,6 @@ static int play_alternative(Play *play, Move *played, Move *alternative, int *de
 			board_unique(&board, &unique);
 			if (board_equal(&excluded, &unique)) {
 				hash_code = board_get_hash_code(&search->board);
-				hash_exclude_move(&search->pv_table, &search->board, hash_code, move->x);
 				hash_exclude_move(&search->hash_table, &search->board, hash_code, move->x);
 				move = movelist_exclude(&search->movelist, move->x);
 			}
@@ -940,6 +938,7 @@ void play_store(Play *play)
 
 	file_add_ext(options.book_file, ".store", file);
 
+	play_stop_pondering(play);
 	play->book->stats.n_nodes = play->book->stats.n_links = 0;
 
 	board = play->initial_board;
@@ -1229,3 +1228,248 @@ const char* play_show_opening_name(Play *play, const char *(*opening_get_name)(c
 	return last;
 }
 
+
+/**
+ * @brief Read an engine configuration of a match.
+ *
+ * The configuration is a comma separated list of "l=<level>", "h=<hash table
+ * size>", "t=<time per move>" & "n=<nodes per move>"; unset values are those
+ * of the current options.
+ *
+ * @param string Engine configuration.
+ * @param engine Output engine configuration.
+ * @return false if the configuration is not valid.
+ */
+bool play_match_engine(const char *string, MatchEngine *engine)
+{
+	char word[64];
+
+	engine->level = options.level;
+	engine->hash_table_size = options.hash_table_size;
+	engine->time = 0;
+	engine->nodes = options.nodes;
+
+	while (*string) {
+		string = parse_field(string, word, 63, ',');
+		if (word[0] == 'l' && word[1] == '=') engine->level = string_to_int(word + 2, -1);
+		else if (word[0] == 'h' && word[1] == '=') engine->hash_table_size = string_to_int(word + 2, -1);
+		else if (word[0] == 't' && word[1] == '=') engine->time = string_to_time(word + 2);
+		else if (word[0] == 'n' && word[1] == '=') engine->nodes = (unsigned long long) MAX(string_to_real(word + 2, 0), 0);
+		else return false;
+	}
+
+	return 0 <= engine->level && engine->level <= 60 && 10 <= engine->hash_table_size && engine->hash_table_size <= 30 && engine->time >= 0;
+}
+
+/** statistics of an engine during a match */
+typedef struct MatchStats {
+	unsigned long long n_nodes; /**< searched nodes */
+	long long time;             /**< time spent */
+	long long max_time;         /**< longest move */
+	int n_moves;                /**< searched moves */
+} MatchStats;
+
+/**
+ * @brief A thread playing the games of a match.
+ */
+typedef struct MatchTask {
+	Thread thread;                 /**< thread */
+	Search *search[2];             /**< searches of both engines */
+	const MatchEngine *engine;     /**< engine configurations */
+	MatchStats stats[2];           /**< statistics of both engines */
+	int result[3];                 /**< losses, draws & wins of the first engine */
+	int discs;                     /**< disc difference of the first engine */
+	int n_plies;                   /**< random plies of the openings */
+	int n_games;                   /**< games to play */
+	SpinLock spin;                 /**< lock on the next game */
+	struct MatchTask *master;      /**< owner of the game counter */
+	int next;                      /**< next game to play */
+	int n_played;                  /**< games played */
+} MatchTask;
+
+/**
+ * @brief Play a game of a match.
+ *
+ * @param task Match task.
+ * @param board Opening position.
+ * @param e Engine to move first.
+ * @return The final score of the first engine.
+ */
+static int match_game(MatchTask *task, Board board, int e)
+{
+	Search *search;
+	Move move;
+	int player = BLACK, score, n_discs_p, n_discs_o;
+	long long t;
+
+	search_cleanup(task->search[0]);
+	search_cleanup(task->search[1]);
+
+	for (;;) {
+		if (!can_move(board.player, board.opponent)) {
+			board_pass(&board);
+			player ^= 1; e ^= 1;
+			if (!can_move(board.player, board.opponent)) break;
+		}
+
+		search = task->search[e];
+		search_set_board(search, &board, player);
+		if (task->engine[e].time) {
+			search_set_level(search, 60, search->eval.n_empties);
+			search_set_move_time(search, task->engine[e].time);
+		} else {
+			search_set_level(search, task->engine[e].level, search->eval.n_empties);
+			search_set_game_time(search, TIME_MAX);
+		}
+
+		t = -real_clock();
+		search_run(search);
+		t += real_clock();
+
+		task->stats[e].n_nodes += search_count_nodes(search);
+		task->stats[e].time += t;
+		task->stats[e].max_time = MAX(task->stats[e].max_time, t);
+		++task->stats[e].n_moves;
+
+		if (board_get_move_flip(&board, search->result->move, &move) == 0 && move.x != PASS) {
+			fatal_error("match: bad move %d\n", search->result->move);
+		}
+		board_update(&board, &move);
+		player ^= 1; e ^= 1;
+	}
+
+	n_discs_p = bit_count(board.player);
+	n_discs_o = bit_count(board.opponent);
+	score = n_discs_p - n_discs_o;
+	if (score < 0) score -= 64 - n_discs_p - n_discs_o;
+	else if (score > 0) score += 64 - n_discs_p - n_discs_o;
+
+	return e == 0 ? score : -score;
+}
+
+/**
+ * @brief Play the games of a match, one at a time.
+ *
+ * Games are played by pairs from the same random opening, each engine moving
+ * first once.
+ *
+ * @param v Match task.
+ * @return NULL.
+ */
+static void* match_task(void *v)
+{
+	MatchTask *task = (MatchTask*) v;
+	MatchTask *master = task->master;
+	Random r;
+	Board board;
+	int i, score;
+
+	for (;;) {
+		spin_lock(master);
+		i = master->next++;
+		spin_unlock(master);
+		if (i >= task->n_games) break;
+
+		random_seed(&r, i / 2 + 1);
+		board_rand(&board, task->n_plies, &r);
+		score = match_game(task, board, i & 1);
+		task->discs += score;
+		++task->result[(score > 0) - (score < 0) + 1];
+
+		spin_lock(master);
+		printf("%d/%d games played\r", ++master->n_played, task->n_games); fflush(stdout);
+		spin_unlock(master);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Print the statistics of an engine.
+ *
+ * @param name Engine name.
+ * @param engine Engine configuration.
+ * @param stats Engine statistics.
+ */
+static void match_print_engine(const char *name, const MatchEngine *engine, const MatchStats *stats)
+{
+	char label[64];
+	int n;
+
+	if (engine->time) n = snprintf(label, sizeof label, "%s  %6.2f s/move, hash %2d", name, 0.001 * engine->time, engine->hash_table_size);
+	else n = snprintf(label, sizeof label, "%s  level %2d     , hash %2d", name, engine->level, engine->hash_table_size);
+	if (engine->nodes && n > 0 && n < (int) sizeof label) snprintf(label + n, sizeof label - n, ", %.0e nodes", (double) engine->nodes);
+	printf("%-37s | %6d %14llu %10.0f %8.3f %8.3f\n", label, stats->n_moves, stats->n_nodes,
+		1000.0 * stats->n_nodes / MAX(stats->time, 1), 0.001 * stats->time / MAX(stats->n_moves, 1), 0.001 * stats->max_time);
+}
+
+/**
+ * @brief Play a match between two engines.
+ *
+ * With several tasks (-n option), the games are played in parallel, each
+ * thread with two single-task searches.
+ *
+ * @param engine Configurations of both engines.
+ * @param n_games Number of games.
+ * @param n_plies Random plies of the openings.
+ */
+void play_match(const MatchEngine *engine, const int n_games, const int n_plies)
+{
+	const int n_task = MAX(1, MIN(options.n_task, (n_games + 1) / 2 * 2));
+	const int hash_table_size = options.hash_table_size, options_n_task = options.n_task;
+	MatchTask *task;
+	MatchStats stats[2];
+	int i, k, result[3] = {0, 0, 0}, discs = 0;
+	long long t = -real_clock();
+
+	task = (MatchTask*) calloc(n_task, sizeof (MatchTask));
+	if (task == NULL) fatal_error("play_match: cannot allocate the tasks\n");
+
+	options.n_task = 1;
+	for (i = 0; i < n_task; ++i) {
+		for (k = 0; k < 2; ++k) {
+			task[i].search[k] = (Search*) mm_malloc(sizeof (Search));
+			if (task[i].search[k] == NULL) fatal_error("play_match: cannot allocate a search\n");
+			options.hash_table_size = engine[k].hash_table_size;
+			search_init(task[i].search[k]);
+			task[i].search[k]->options.verbosity = 0;
+			task[i].search[k]->options.nodes = engine[k].nodes;
+		}
+		task[i].engine = engine;
+		task[i].n_plies = n_plies;
+		task[i].n_games = n_games;
+		task[i].master = task;
+	}
+	options.hash_table_size = hash_table_size;
+	options.n_task = options_n_task;
+	spin_init(task);
+
+	for (i = 1; i < n_task; ++i) thread_create(&task[i].thread, match_task, task + i);
+	match_task(task);
+	for (i = 1; i < n_task; ++i) thread_join(task[i].thread);
+
+	memset(stats, 0, sizeof stats);
+	for (i = 0; i < n_task; ++i) {
+		for (k = 0; k < 2; ++k) {
+			stats[k].n_nodes += task[i].stats[k].n_nodes;
+			stats[k].time += task[i].stats[k].time;
+			stats[k].max_time = MAX(stats[k].max_time, task[i].stats[k].max_time);
+			stats[k].n_moves += task[i].stats[k].n_moves;
+			search_free(task[i].search[k]);
+			mm_free(task[i].search[k]);
+		}
+		for (k = 0; k < 3; ++k) result[k] += task[i].result[k];
+		discs += task[i].discs;
+	}
+	spin_free(task);
+	free(task);
+	t += real_clock();
+
+	printf("\nmatch: %d games, %d random plies, %d threads, ", n_games, n_plies, n_task);
+	time_print(t, false, stdout); putchar('\n');
+	printf("A vs B: +%d =%d -%d, score %.1f%%, discs %+.2f/game\n", result[2], result[1], result[0],
+		50.0 * (2 * result[2] + result[1]) / MAX(n_games, 1), (double) discs / MAX(n_games, 1));
+	printf("%-37s |  moves          nodes   nodes/s   s/move    max s\n", "");
+	match_print_engine("A", engine, stats);
+	match_print_engine("B", engine + 1, stats + 1);
+}
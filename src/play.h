@@ -59,6 +59,14 @@ typedef struct Play {
 	char error_message[PLAY_MESSAGE_MAX_LENGTH]; /**< error message */
 } Play;
 
+/** engine configuration of a match */
+typedef struct MatchEngine {
+	int level;                 /**< search level */
+	int hash_table_size;       /**< hash table size (log2 of entries) */
+	long long time;            /**< time per move, or 0 to search at the level */
+	unsigned long long nodes;  /**< node budget per move, or 0 for none */
+} MatchEngine;
+
 /* functions */
 void play_init(Play*, Book*);
 void play_free(Play*);
@@ -96,6 +104,8 @@ void play_force_restore(Play*);
 bool play_force_go(Play*, Move*);
 void play_symetry(Play*, const int);
 const char* play_show_opening_name(Play*, const char *(*opening_get_name)(const Board*));
+bool play_match_engine(const char*, MatchEngine*);
+void play_match(const MatchEngine*, const int, const int);
 // bool play_is_game_over(Play*);
 // bool play_must_pass(Play *play);
 #define	play_is_game_over(play)	board_is_game_over(&(play)->board)
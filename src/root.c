@@ -49,7 +49,7 @@ void pv_debug(Search *search, const Move *bestmove, FILE *f)
 
 	x = bestmove->x;
 	fprintf(f, "pv = %s ", move_to_string(x, player, s));
-	if (hash_get_from_board(&search->pv_table, &board, &hash_data)) {
+	if (hash_get_from_board(&search->hash_table, &board, &hash_data)) {
 		fprintf(f, ":%02d@%d%%[%+03d,%+03d]; ", hash_data.wl.c.depth, selectivity_table[hash_data.wl.c.selectivity].percent, hash_data.lower, hash_data.upper);
 	}
 	while (x != NOMOVE) {
@@ -58,12 +58,9 @@ void pv_debug(Search *search, const Move *bestmove, FILE *f)
 		player ^= 1;
 
 		hash_code = board_get_hash_code(&board);
-		if (hash_get(&search->pv_table, &board, hash_code, &hash_data)) {
+		if (hash_get(&search->hash_table, &board, hash_code, &hash_data)) {
 			x = hash_data.move[0];
 			fprintf(f, "%s:%02d@%d%%[%+03d,%+03d]; ", move_to_string(x, player, s), hash_data.wl.c.depth, selectivity_table[hash_data.wl.c.selectivity].percent, hash_data.lower, hash_data.upper);
-		} else if (hash_get(&search->hash_table, &board, hash_code, &hash_data)) {
-			x = hash_data.move[0];
-			fprintf(f, "{%s}:%2d@%d%%[%+03d,%+03d]; ", move_to_string(x, player, s), hash_data.wl.c.depth, selectivity_table[hash_data.wl.c.selectivity].percent, hash_data.lower, hash_data.upper);
 		} else x = NOMOVE;
 	}
 	fputc('\n', f);
@@ -96,8 +93,7 @@ bool is_pv_ok(Search *search, int bestmove, int search_depth)
 		board_update(&board, &move);
 
 		hash_code = board_get_hash_code(&board);
-		if (hash_get(&search->pv_table, &board, hash_code, &hash_data)
-		 || hash_get(&search->hash_table, &board, hash_code, &hash_data)) {
+		if (hash_get(&search->hash_table, &board, hash_code, &hash_data)) {
 			x = hash_data.move[0];
 		} else break;
 		if (hash_data.wl.c.depth < search_depth || hash_data.wl.c.selectivity < search->selectivity || hash_data.lower != hash_data.upper) return false;
@@ -197,7 +193,7 @@ void record_best_move(Search *search, const Move *bestmove, const int alpha, con
 			line_push(&result->pv, move.x);
 
 			hash_code = board_get_hash_code(&board);
-			if ((hash_get(&search->pv_table, &board, hash_code, &hash_data) || hash_get(&search->hash_table, &board, hash_code, &hash_data)) 
+			if (hash_get(&search->hash_table, &board, hash_code, &hash_data)
 			 && (hash_data.wl.c.depth >= expected_depth && hash_data.wl.c.selectivity >= expected_selectivity)
 			 && (hash_data.upper <= expected_bound.upper && hash_data.lower >= expected_bound.lower)) {
 				x = hash_data.move[0];
@@ -293,6 +289,8 @@ static int search_route_PVS(Search *search, int alpha, int beta, const int depth
  * @brief Compute a cost as a combination of node count, depth, etc. from hash_table.
  *
  * The board is supposed to be updated by a move after the root position.
+ * The cost, i.e. the log2 of the node count, is followed by the selectivity,
+ * to fit in the 16 bits of a move.
  *
  * @param search Search.
  * @return A search cost. 
@@ -300,13 +298,12 @@ static int search_route_PVS(Search *search, int alpha, int beta, const int depth
 int search_get_pv_cost(Search *search)
 {
 	HashTable *hash_table = &search->hash_table;
-	HashTable *pv_table = &search->pv_table;
 	HashTable *shallow_table = &search->shallow_table;
 	HashData hash_data;
 	const unsigned long long hash_code = board_get_hash_code(&search->board);
 
-	if ((hash_get(pv_table, &search->board, hash_code, &hash_data) || hash_get(hash_table, &search->board, hash_code, &hash_data) || hash_get(shallow_table, &search->board, hash_code, &hash_data))) {
-		return writeable_level(&hash_data);
+	if ((hash_get(hash_table, &search->board, hash_code, &hash_data) || hash_get(shallow_table, &search->board, hash_code, &hash_data))) {
+		return (hash_data.wl.c.cost << 8) + hash_data.wl.c.selectivity;
 	}
 	return 0;
 }
@@ -354,7 +351,9 @@ int PVS_root(Search *search, const int alpha, const int beta, const int depth)
 
 	// special cases: pass or game over
 	if (movelist_is_empty(movelist)) {
-		move = movelist->move->next = movelist->move + 1;
+		move = movelist->move + 1;
+		move_set_next(movelist->move, move);
+		move->next = 0;
 		move->flipped = 0;
 		if (can_move(search->board.opponent, search->board.player)) {
 			search_update_pass_midgame(search, &eval0);
@@ -415,7 +414,7 @@ int PVS_root(Search *search, const int alpha, const int beta, const int depth)
 
 	if (!search->stop) {
 		hash_code = board_get_hash_code(&search->board);
-		hash_get(&search->pv_table, &search->board, hash_code, &hash_data.data);
+		hash_get(&search->hash_table, &search->board, hash_code, &hash_data.data);
 		if (movelist->n_moves) {	// 4.5.1
 			if (depth < search->options.multipv_depth) movelist_sort(movelist);
 			else movelist_sort_cost(movelist, &hash_data.data);
@@ -432,9 +431,8 @@ int PVS_root(Search *search, const int alpha, const int beta, const int depth)
 			hash_data.beta = beta;
 			hash_data.score = node.bestscore;
 
-			hash_store(&search->hash_table, &search->board, hash_code, &hash_data);
-			if (search->options.guess_pv) hash_force(&search->pv_table, &search->board, hash_code, &hash_data);
-			else hash_store(&search->pv_table, &search->board, hash_code, &hash_data);
+			if (search->options.guess_pv) hash_force_pv(&search->hash_table, &search->board, hash_code, &hash_data);
+			else hash_store_pv(&search->hash_table, &search->board, hash_code, &hash_data);
 		}
 
 		assert(SCORE_MIN <= node.bestscore && node.bestscore <= SCORE_MAX);
@@ -590,8 +588,7 @@ static bool get_last_level(Search *search, int *depth, int *selectivity)
 
 	for (i = 0; i < 4; ++i) {
 		hash_code = board_get_hash_code(&board);
-		if (hash_get(&search->pv_table, &board, hash_code, &hash_data)
-		 || hash_get(&search->hash_table, &board, hash_code, &hash_data)) {
+		if (hash_get(&search->hash_table, &board, hash_code, &hash_data)) {
 			x = hash_data.move[0];
 		} else break;
 
@@ -681,7 +678,7 @@ void iterative_deepening(Search *search, int alpha, int beta)
 	}
 
 	// reuse last search ?
-	if (hash_get_from_board(&search->pv_table, &search->board, &hash_data)) {
+	if (hash_get_from_board(&search->hash_table, &search->board, &hash_data)) {
 		char s[2][3];
 		if (search->options.verbosity >= 2) {
 			info("<hash: value = [%+02d, %+02d] ; bestmove = %s, %s ; level = %d@%d%% ; date = %d ; cost = %d>\n",
@@ -727,7 +724,7 @@ void iterative_deepening(Search *search, int alpha, int beta)
 	}
 
 	if (log_is_open(search_log)) {
-		log_print(search_log,"date: pv = %d, main = %d %s\n", search->pv_table.date, search->hash_table.date, search->options.keep_date ? "(keep)":"");
+		log_print(search_log,"date: %d %s\n", search->hash_table.date, search->options.keep_date ? "(keep)":"");
 		log_print(search_log,"iterating from level %d@%d\n", start, selectivity_table[search->selectivity].percent);
 		log_print(search_log, "alloted time: mini=%.1fs maxi=%.1fs extra=%.1fs\n", 0.001 * search->time.mini, 0.001 * search->time.maxi, 0.001 * search->time.extra);
 		unlock(search_log);
@@ -820,13 +817,16 @@ void* search_run(void *v)
 	//initialisations
 	search->n_nodes = 0;
 	search->child_nodes = 0;
+	search->nodes_checked = search->nodes_unchecked = 0;
 	search->time.spent = -search_clock(search);
 	search_time_init(search);
+	if (options.memory) search_resize_hashtable(search); // the budget share may have changed
 	if (!search->options.keep_date) {
 		hash_clear(&search->hash_table);
-		hash_clear(&search->pv_table);
 		hash_clear(&search->shallow_table);
 	}
+	hash_set_root(&search->hash_table, &search->board);
+	hash_set_root(&search->shallow_table, &search->board);
 	search->height = 0;
 	search->node_type[search->height] = PV_NODE;
 	search->depth_pv_extension = get_pv_extension(0, search->eval.n_empties);
@@ -847,7 +847,9 @@ void* search_run(void *v)
 	}
 	
 	// search using iterative deepening (& widening).
-	iterative_deepening(search, options.alpha, options.beta);
+	search_timer_start(search);
+	iterative_deepening(search, MAX(options.alpha, search->options.alpha), MIN(options.beta, search->options.beta));
+	search_timer_stop(search);
 
 	// finalizations
 	search->result->n_nodes = search_count_nodes(search);
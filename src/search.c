@@ -60,6 +60,7 @@
 #include "search.h"
 
 #include "bit.h"
+#include "book.h"
 #include "options.h"
 #include "stats.h"
 #include "util.h"
@@ -73,6 +74,9 @@
 
 Log search_log[1];
 
+/** Number of initialized searches (created & freed by the main thread) */
+static int n_searches = 0;
+
 #ifdef _MSC_VER
 #define log2(x) (log(x)/log(2.0))
 #endif
@@ -345,15 +349,63 @@ void search_global_init(void)
 	search_log->f = NULL;
 }
 
-void search_resize_hashtable(Search *search) {
-	if (search->options.hash_size != options.hash_table_size) {
-		const int hash_size = 1u << options.hash_table_size;
-		const int pv_size = hash_size > 16 ? hash_size >> 4 : 16;
+/**
+ * @brief Split the memory budget between the hash tables.
+ *
+ * The evaluation weights and the book index, if any, are taken out of the
+ * budget first. The remainder is shared evenly by the live searches (the
+ * per-thread searches of the parallel tools are single-task searches of
+ * their own), then by their main & shallow tables, without rounding the
+ * sizes. The PV entries live in the main table.
+ *
+ * @param search Search.
+ * @param hash_size Main & shallow table size (in entries).
+ */
+static void search_memory_layout(const Search *search, unsigned long long *hash_size)
+{
+	static unsigned long long reported = 0;
+	const unsigned long long eval_memory = EVAL_WEIGHT ? sizeof (*EVAL_WEIGHT) : 0;
+	const unsigned long long book_memory = book_index_memory(search->book_index);
+	const unsigned long long fixed = eval_memory + book_memory;
+	const unsigned long long n = options.memory > fixed ? (options.memory - fixed) / sizeof (Hash) / MAX(n_searches, 1) : 0;
+
+	*hash_size = MAX(n / 2, 1024);
+
+	if (options.verbosity && reported != *hash_size) {
+		fprintf(stderr, "memory budget:");
+		print_scientific(options.memory, "B", stderr);
+		fprintf(stderr, " = eval"); print_scientific(eval_memory, "B", stderr);
+		fprintf(stderr, " + book index"); print_scientific(book_memory, "B", stderr);
+		fprintf(stderr, " + %d x 2 x hash", MAX(n_searches, 1)); print_scientific(*hash_size * sizeof (Hash), "B", stderr);
+		fprintf(stderr, " (%llu entries)\n", *hash_size);
+		if (fixed + 2 * MAX(n_searches, 1) * *hash_size * sizeof (Hash) > options.memory) warn("the memory budget is too small\n");
+		reported = *hash_size;
+	}
+}
+
+/**
+ * @brief Resize the hash tables.
+ *
+ * The sizes come from the memory budget (-memory) if set, or else from
+ * the hash table size in bits (-hash-table-size). The tables are only
+ * reallocated when their size changes.
+ *
+ * @param search Search.
+ */
+void search_resize_hashtable(Search *search)
+{
+	unsigned long long hash_size;
+
+	if (options.memory) {
+		search_memory_layout(search, &hash_size);
+	} else {
+		hash_size = 1ULL << options.hash_table_size;
+	}
 
+	if (search->options.hash_size != hash_size) {
 		hash_init(&search->hash_table, hash_size);
-		hash_init(&search->pv_table, pv_size);
 		hash_init(&search->shallow_table, hash_size);
-		search->options.hash_size = options.hash_table_size;
+		search->options.hash_size = hash_size;
 	}
 }
 
@@ -371,14 +423,16 @@ void search_init(Search *search)
 	/* running state */
 	search->stop = STOP_END;
 
+	/* opening book index (sizes the hash tables under a memory budget) */
+	search->book_index = NULL;
+
 	/* hash_table */
 	search->options.hash_size = 0;
 	search->hash_table.hash = NULL;
 	search->hash_table.hash_mask = 0;
-	search->pv_table.hash = NULL;
-	search->pv_table.hash_mask = 0;
 	search->shallow_table.hash = NULL;
 	search->shallow_table.hash_mask = 0;
+	++n_searches;
 	search_resize_hashtable(search);
 
 	/* board */
@@ -417,6 +471,11 @@ void search_init(Search *search)
 	/* lock */
 	spin_init(search);
 
+	/* timer */
+	lock_init(&search->timer);
+	condition_init(&search->timer);
+	search->timer.run = search->timer.alive = search->timer.quit = false;
+
 	/* result */
 	search->result = (Result*) malloc(sizeof (Result));
 	if (search->result == NULL) {
@@ -427,6 +486,7 @@ void search_init(Search *search)
 
 	search->n_nodes = 0;
 	search->child_nodes = 0;
+	search->nodes_checked = search->nodes_unchecked = 0;
 
 
 	/* observers */
@@ -443,6 +503,9 @@ void search_init(Search *search)
 	search->options.separator = NULL;
 	search->options.guess_pv = options.pv_guess;
 	search->options.multipv_depth = MULTIPV_DEPTH;
+	search->options.alpha = SCORE_MIN;
+	search->options.beta = SCORE_MAX;
+	search->options.nodes = 0;
 
 	log_open(search_log, options.search_log_file);
 }
@@ -457,18 +520,31 @@ void search_free(Search *search)
 {
 
 	hash_free(&search->hash_table);
-	hash_free(&search->pv_table);
 	hash_free(&search->shallow_table);
+	book_index_free(search->book_index);
+	search->book_index = NULL;
 	// eval_free(search->eval);
 	
 	task_stack_free(search->tasks);
 	free(search->tasks);
 	spin_free(search);
+	if (search->timer.alive) {
+		lock(&search->timer);
+		search->timer.quit = true;
+		condition_signal(&search->timer);
+		unlock(&search->timer);
+		thread_join(search->timer.thread);
+	}
+	condition_free(&search->timer);
+	lock_free(&search->timer);
 
 	spin_free(search->result);
 	free(search->result);
 
-	log_close(search_log);
+	// the log is shared by all the searches: only the last one closes it.
+	if (--n_searches == 0) {
+		log_close(search_log);
+	}
 }
 
 /**
@@ -536,8 +612,8 @@ void search_clone(Search *search, Search *master)
 	search->board = master->board;
 	search_setup(search);
 	search->hash_table = master->hash_table; // share the hashtable
-	search->pv_table = master->pv_table; // share the pvtable
 	search->shallow_table = master->shallow_table; // share the shallowtable
+	search->book_index = master->book_index; // share the book index
 	search->tasks = master->tasks;
 	search->observer = master->observer;
 
@@ -553,6 +629,7 @@ void search_clone(Search *search, Search *master)
 	search->result = master->result;
 	search->n_nodes = 0;
 	search->child_nodes = 0;
+	search->nodes_checked = search->nodes_unchecked = 0;
 	search->stability_bound = master->stability_bound;
 	spin_lock(master);
 	assert(master->n_child < MAX_THREADS);
@@ -570,7 +647,6 @@ void search_clone(Search *search, Search *master)
 void search_cleanup(Search *search)
 {
 	hash_cleanup(&search->hash_table);
-	hash_cleanup(&search->pv_table);
 	hash_cleanup(&search->shallow_table);
 }
 
@@ -785,14 +861,16 @@ bool search_continue(Search *search)
 }
 
 /**
- * @brief Check if it can iterate more...
+ * @brief Stop the search if it is out of time.
  *
- * @param search Search.
+ * When the alloted time is over, the time is extended once if the best move
+ * is not settled yet, otherwise all the searches are stopped.
+ *
+ * @param master Master search.
  */
-void search_check_timeout(Search *search)
+static void search_check_time(Search *master)
 {
 	long long t;
-	Search *master = search->master;
 
 	assert(master->master == master);
 
@@ -815,21 +893,146 @@ void search_check_timeout(Search *search)
 				}
 				spin_unlock(result);
 			}
-			if (t > search->time.extra) {
+			if (t > master->time.extra) {
 				search_stop_all(master, STOP_TIMEOUT);
 			}
 		}
 	}	
+}
 
-	if (search->stop != STOP_TIMEOUT) {
-		t = search_time(master);
-		if (t > master->time.extra) {
-			printf("*** SEARCH STILL RUNNING ? (%d) ***\n", search->stop);
-			search->stop = STOP_TIMEOUT;
+/**
+ * @brief Count the nodes of a search and of its running helper searches.
+ *
+ * @param search Search.
+ * @return node count.
+ */
+static unsigned long long search_count_all_nodes(Search *search)
+{
+	unsigned long long n;
+	int i;
+
+	spin_lock(search);
+		n = search_count_nodes(search);
+		for (i = 0; i < search->n_child; ++i) {
+			n += search_count_all_nodes(search->child[i]);
+		}
+	spin_unlock(search);
+
+	return n;
+}
+
+/**
+ * @brief Check the node budget of a search.
+ *
+ * The node budget, the search own one or else the global one, counts the
+ * nodes of all the helper searches too. Counting them locks the whole search
+ * tree, so each search only counts them again after having searched its share
+ * of the remaining budget by itself, and the checks get denser as the limit
+ * gets closer. A single task search still stops at the first midgame node
+ * reaching the budget, from one run to the next.
+ *
+ * @param search Search.
+ * @param nodes Node budget.
+ */
+static void search_check_nodes(Search *search, const unsigned long long nodes)
+{
+	Search *master = search->master;
+	unsigned long long n;
+
+	// a node counter reset makes the difference wrap around & forces a check
+	if (search->n_nodes - search->nodes_checked >= search->nodes_unchecked && master->stop == RUNNING) {
+		n = search_count_all_nodes(master);
+		if (n >= nodes) search_stop_all(master, STOP_TIMEOUT);
+		else {
+			search->nodes_checked = search->n_nodes;
+			search->nodes_unchecked = (nodes - n) / search_count_tasks(master);
 		}
 	}
 }
 
+/**
+ * @brief Check the time from a search node.
+ *
+ * Only the node budget and the search time in nps mode depend on the searched
+ * nodes and are checked here; the real time is checked by the timer thread.
+ *
+ * @param search Search.
+ */
+void search_check_timeout(Search *search)
+{
+	Search *master = search->master;
+	const unsigned long long nodes = master->options.nodes ? master->options.nodes : options.nodes;
+
+	if (nodes) search_check_nodes(search, nodes);
+	if (options.nps > 0) search_check_time(master);
+}
+
+/**
+ * @brief The timer thread: check the time of the master search periodically.
+ *
+ * The thread lives as long as the search and sleeps between its runs.
+ *
+ * @param v Master search.
+ * @return NULL.
+ */
+static void* search_timer(void *v)
+{
+	Search *search = (Search*) v;
+
+	lock(&search->timer);
+	while (!search->timer.quit) {
+		if (search->timer.run) {
+			condition_timedwait(&search->timer, SEARCH_TIMER_PERIOD);
+			if (search->timer.run) search_check_time(search);
+		} else {
+			condition_wait(&search->timer);
+		}
+	}
+	unlock(&search->timer);
+
+	return NULL;
+}
+
+/**
+ * @brief Start the timer of the master search.
+ *
+ * In nps mode, the time is checked by the search nodes instead, and without
+ * time limit (e.g. at a fixed level) there is nothing to check. The timer
+ * thread is created by the first timed run.
+ *
+ * @param search Master search.
+ */
+void search_timer_start(Search *search)
+{
+	if (options.nps <= 0 && search->options.time < TIME_MAX) {
+		lock(&search->timer);
+		search->timer.run = true;
+		if (search->timer.alive) {
+			condition_signal(&search->timer);
+		} else {
+			thread_create(&search->timer.thread, search_timer, search);
+			search->timer.alive = true;
+		}
+		unlock(&search->timer);
+	}
+}
+
+/**
+ * @brief Stop the timer of the master search.
+ *
+ * Once stopped, the timer does not check the search time anymore.
+ *
+ * @param search Master search.
+ */
+void search_timer_stop(Search *search)
+{
+	if (search->timer.run) {
+		lock(&search->timer);
+		search->timer.run = false;
+		unlock(&search->timer);
+	}
+}
+
 /**
  * @brief Change the number of task.
  *
@@ -879,11 +1082,12 @@ void search_get_movelist(const Search *search, MoveList *movelist)
 		move->x = x;
 		move->flipped = vboard_flip(vboard, x);
 		move->cost = 0;
-		previous = previous->next = move;
+		move_set_next(previous, move);
+		previous = move;
 		++move;
 		++(movelist->n_moves);
 	}
-	previous->next = NULL;
+	previous->next = 0;
 }
 
 #if 0	// inlined
@@ -1330,7 +1534,6 @@ bool search_ETC_NWS(Search *search, MoveList *movelist, unsigned long long hash_
  */
 void search_share(const Search *src, Search *dest)
 {
-	hash_copy(&src->pv_table, &dest->pv_table);
 	hash_copy(&src->hash_table, &dest->hash_table);
 }
 
@@ -1392,8 +1595,7 @@ int search_guess(Search *search, const Board *board)
 	unsigned long long hash_code;
 
 	hash_code = board_get_hash_code(board);
-	if (hash_get(&search->pv_table, board, hash_code, &hash_data)) move = hash_data.move[0];
-	if (move == NOMOVE && hash_get(&search->hash_table, board, hash_code, &hash_data)) move = hash_data.move[0];
+	if (hash_get(&search->hash_table, board, hash_code, &hash_data)) move = hash_data.move[0];
 
 	return move;
 }
@@ -31,6 +31,7 @@ typedef struct Selectivity {
 
 struct Task;
 struct TaskQueue;
+struct BookIndex;
 
 /** Bound */
 typedef struct Bound {
@@ -67,6 +68,8 @@ typedef struct Search {
 
 	volatile unsigned long long n_nodes;          /**< node counter (8) */
 	volatile unsigned long long child_nodes;      /**< node counter (8) */
+	unsigned long long nodes_checked;             /**< node counter at the last node budget check */
+	unsigned long long nodes_unchecked;           /**< nodes to search before the next node budget check */
 
 	Eval eval;                                    /**< eval */
 
@@ -75,8 +78,8 @@ typedef struct Search {
 	int id;                                       /**< search id */
 
 	HashTable hash_table;                         /**< hashtable */
-	HashTable pv_table;                           /**< hashtable for the pv */
 	HashTable shallow_table;                      /**< hashtable for short search */
+	struct BookIndex *book_index;                 /**< opening book probed during the search */
 	Random random;                                /**< random generator */
 
 	struct TaskStack *tasks;                      /**< available task queue */
@@ -101,6 +104,14 @@ typedef struct Search {
 		long long  mini;                          /**< minimal alloted time */
 		long long  maxi;                          /**< maximal alloted time */
 	} time;                                       /**< time */
+	struct {
+		Thread thread;                            /**< timer thread */
+		Lock lock;                                /**< timer lock */
+		Condition cond;                           /**< timer wake-up */
+		volatile bool run;                        /**< timer running */
+		bool alive;                               /**< timer thread created */
+		bool quit;                                /**< timer thread to end */
+	} timer;                                      /**< timer stopping the search on time out */
 	MoveList movelist;                            /**< list of moves */
 	int height;                                   /**< search height from root */
 	NodeType node_type[GAME_SIZE];                /**< node type (pv node, cut node, all node) */
@@ -117,7 +128,10 @@ typedef struct Search {
 		const char *separator;                    /**< separator for search output */
 		bool guess_pv;                            /**< guess PV (in cassio mode only) */
 		int multipv_depth;                        /**< multi PV depth */
-		int hash_size;                            /**< hashtable size */
+		int alpha;                                /**< lower bound of the root window */
+		int beta;                                 /**< upper bound of the root window */
+		unsigned long long hash_size;             /**< hashtable size (in entries) */
+		unsigned long long nodes;                 /**< node budget, or 0 for the global one (-nodes) */
 	} options;                                    /**< local (threadable) options. */
 
 	Result *result;                               /**< shared result */
@@ -152,6 +166,8 @@ void search_set_move_time(Search*, const long long);
 void search_time_init(Search*);
 void search_time_reset(Search*, const Board*);
 void search_adjust_time(Search*, const bool);
+void search_timer_start(Search*);
+void search_timer_stop(Search*);
 bool search_continue(Search *);
 void search_check_timeout(Search *search);
 
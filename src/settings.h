@@ -117,6 +117,11 @@
 /** Swith from endgame to shallow search (faster but less node efficient) at this depth. */
 #define DEPTH_TO_SHALLOW_SEARCH 7
 
+/** Order endgame moves by the parity of connected empty regions instead of quadrants (changes node counts). */
+#ifndef USE_REGION_PARITY
+	#define USE_REGION_PARITY false
+#endif
+
 /** Switch from midgame to endgame search (faster but less node efficient) at this depth. */
 #define DEPTH_MIDGAME_TO_ENDGAME 15
 
@@ -129,6 +134,12 @@
 /** Try ETC down to this depth. */
 #define ETC_MIN_DEPTH 5
 
+/** Try ETC in the endgame search down to this number of empties. */
+#define ETC_MIN_EMPTIES 12
+
+/** Set up the evaluation with pext, rather than square by square, from this number of squares to walk. */
+#define EVAL_PEXT_MIN_SQUARES 48
+
 /** bound for usefull move sorting */
 #define SORT_ALPHA_DELTA 8
 
@@ -156,5 +167,14 @@
 /** multi_pv depth */
 #define MULTIPV_DEPTH 10
 
+/** Search timer period (in ms). */
+#define SEARCH_TIMER_PERIOD 1
+
+/** Log ring buffer size (must be a power of 2). */
+#define LOG_BUFFER_SIZE (1 << 20)
+
+/** Log writer polling period (in ms). */
+#define LOG_WRITER_PERIOD 20
+
 #endif /* EDAX_SETTINGS_H */
 
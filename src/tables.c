@@ -0,0 +1,70 @@
+/**
+ * @file tables.c
+ *
+ * This module generates the precomputed tables.
+ *
+ * Some tables are fixed, and computing them at startup only delays the first
+ * search. They are generated once, by "make tables", into C sources that are
+ * compiled as constant data. Debug builds still compute them at startup to
+ * check the generated sources are up to date.
+ *
+ * @date 1998 - 2023
+ * @author Richard Delorme
+ * @version 4.4
+ */
+
+#define EDAX_HARNESS
+#include "all.c"
+
+/**
+ * @brief Write a table of bytes as a C constant array.
+ *
+ * @param f output file.
+ * @param comment table description.
+ * @param declaration array declaration.
+ * @param table table data.
+ * @param n table size.
+ */
+static void tables_write_bytes(FILE *f, const char *comment, const char *declaration, const unsigned char *table, const int n)
+{
+	int i;
+
+	fprintf(f, "/** %s */\n%s = {", comment, declaration);
+	for (i = 0; i < n; ++i) {
+		if (i % 16 == 0) fputs("\n\t", f); else fputc(' ', f);
+		fprintf(f, "0x%02x%s", table[i], i + 1 < n ? "," : "");
+	}
+	fputs("\n};\n", f);
+}
+
+/**
+ * @brief Generate the precomputed tables.
+ *
+ * @param argc number of arguments.
+ * @param argv edge stability source to write.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int main(int argc, char **argv)
+{
+	static unsigned char table[256 * 256];
+	FILE *f;
+
+	if (argc != 2) {
+		fprintf(stderr, "usage: %s edge_stability.h\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	bit_init();
+	edge_stability_generate(table);
+
+	f = fopen(argv[1], "w");
+	if (f == NULL) {
+		fprintf(stderr, "Cannot open %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	fputs("/**\n * @file edge_stability.h\n *\n * Precomputed edge stability table, generated by tables.c (\"make tables\").\n * Do not edit.\n */\n\n", f);
+	tables_write_bytes(f, "edge stability global data", "const unsigned char edge_stability[256 * 256]", table, 256 * 256);
+	fclose(f);
+
+	return EXIT_SUCCESS;
+}
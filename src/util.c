@@ -42,7 +42,9 @@
 #if defined(__linux__)
 
 #include <sys/sysinfo.h>
+#include <sys/syscall.h>
 #include <sched.h>
+#include <linux/perf_event.h>
 
 #endif // __linux__
 
@@ -197,6 +199,29 @@ void time_stamp(FILE *f)
 }
 
 
+#if defined(__unix__) || (defined(_WIN32) && defined(USE_PTHREAD)) || defined(__APPLE__)
+/**
+ * @brief Wait for a condition change, at most t ms.
+ *
+ * @param cond Condition.
+ * @param lock Locked mutex associated to the condition.
+ * @param t time in ms.
+ */
+void pthread_cond_timedwait_ms(pthread_cond_t *cond, pthread_mutex_t *lock, const int t)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += t / 1000;
+	ts.tv_nsec += (t % 1000) * 1000000;
+	if (ts.tv_nsec >= 1000000000) {
+		++ts.tv_sec;
+		ts.tv_nsec -= 1000000000;
+	}
+	pthread_cond_timedwait(cond, lock, &ts);
+}
+#endif
+
 /**
  * @brief sleep for t ms.
  * @param t time in ms.
@@ -355,6 +380,34 @@ long long string_to_time(const char *string)
 	return t;
 }
 
+/**
+ * @brief Read a memory size as a number of bytes, with an optional K, M, G or T suffix.
+ *
+ * @param string Size as a string (for example "512M" or "1.5G").
+ * @return Size in bytes, or 0 if the string is not a size.
+ */
+unsigned long long string_to_size(const char *string)
+{
+	double x = 0.0;
+	const char *s;
+
+	if (string == NULL) return 0;
+	s = parse_real(parse_skip_spaces(string), &x);
+	switch (toupper(*s)) {
+	case 'T': x *= 1024.0;
+	/* FALLTHRU */
+	case 'G': x *= 1024.0;
+	/* FALLTHRU */
+	case 'M': x *= 1024.0;
+	/* FALLTHRU */
+	case 'K': x *= 1024.0;
+	/* FALLTHRU */
+	default: break;
+	}
+
+	return x > 0.0 ? (unsigned long long) x : 0;
+}
+
 /**
  * @brief Change all char of a string to lowercase.
  *
@@ -1042,6 +1095,358 @@ int get_cpu_number(void)
 	return n;
 }
 
+/**
+ * @brief Open the hardware performance counters of the calling thread.
+ *
+ * The counters, read with Linux perf_event_open, count the user space
+ * events of this thread only. A counter unavailable on this system (VM,
+ * permissions, no such event) is left unused.
+ *
+ * @param perf Performance counters.
+ * @return the number of available counters.
+ */
+int perf_counters_open(PerfCounters *perf)
+{
+	int i, n = 0;
+#if defined(__linux__)
+	static const struct { unsigned int type; unsigned long long config; } event[PERF_N_COUNTERS] = {
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+		{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+		{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+	};
+	struct perf_event_attr attr;
+
+	for (i = 0; i < PERF_N_COUNTERS; ++i) {
+		memset(&attr, 0, sizeof attr);
+		attr.size = sizeof attr;
+		attr.type = event[i].type;
+		attr.config = event[i].config;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		perf->fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		if (perf->fd[i] >= 0) ++n;
+		perf->start[i] = perf->count[i] = 0;
+	}
+#else
+	for (i = 0; i < PERF_N_COUNTERS; ++i) {
+		perf->fd[i] = -1;
+		perf->start[i] = perf->count[i] = 0;
+	}
+#endif
+	return n;
+}
+
+/**
+ * @brief Close the performance counters.
+ *
+ * @param perf Performance counters.
+ */
+void perf_counters_close(PerfCounters *perf)
+{
+	int i;
+
+	for (i = 0; i < PERF_N_COUNTERS; ++i) {
+#if defined(__linux__)
+		if (perf->fd[i] >= 0) close(perf->fd[i]);
+#endif
+		perf->fd[i] = -1;
+	}
+}
+
+/**
+ * @brief Read the current value of a counter.
+ *
+ * @param perf Performance counters.
+ * @param i Counter index.
+ * @return the counter value, or 0 if unavailable.
+ */
+static unsigned long long perf_counter_read(const PerfCounters *perf, const int i)
+{
+	unsigned long long value = 0;
+
+#if defined(__linux__)
+	if (perf->fd[i] < 0 || read(perf->fd[i], &value, sizeof value) != sizeof value) value = 0;
+#else
+	(void) perf; (void) i;
+#endif
+	return value;
+}
+
+/**
+ * @brief Start counting.
+ *
+ * The counters of a thread may be started & stopped from another thread.
+ *
+ * @param perf Performance counters.
+ */
+void perf_counters_start(PerfCounters *perf)
+{
+	int i;
+
+	for (i = 0; i < PERF_N_COUNTERS; ++i) perf->start[i] = perf_counter_read(perf, i);
+}
+
+/**
+ * @brief Stop counting, and keep the counts since the start.
+ *
+ * @param perf Performance counters.
+ */
+void perf_counters_stop(PerfCounters *perf)
+{
+	int i;
+
+	for (i = 0; i < PERF_N_COUNTERS; ++i) perf->count[i] = perf_counter_read(perf, i) - perf->start[i];
+}
+
+/**
+ * @brief Print the counts divided by a number of nodes or calls.
+ *
+ * @param perf Performance counters.
+ * @param name Line header.
+ * @param n Divider.
+ * @param unit Divider's name.
+ * @param f Output stream.
+ */
+void perf_counters_print(const PerfCounters *perf, const char *name, const double n, const char *unit, FILE *f)
+{
+	static const char *label[PERF_N_COUNTERS] = { "cycles", "instructions", "L1D misses", "LLC misses", "dTLB misses", "branch misses" };
+	int i;
+
+	fprintf(f, "%s:", name);
+	for (i = 0; i < PERF_N_COUNTERS; ++i) {
+		if (perf->fd[i] < 0) fprintf(f, " %s n/a,", label[i]);
+		else fprintf(f, " %s %.3g,", label[i], perf->count[i] / n);
+	}
+	if (perf->fd[PERF_CYCLES] >= 0 && perf->fd[PERF_INSTRUCTIONS] >= 0 && perf->count[PERF_CYCLES] > 0)
+		fprintf(f, " IPC %.2f,", (double) perf->count[PERF_INSTRUCTIONS] / perf->count[PERF_CYCLES]);
+	fprintf(f, " per %s\n", unit);
+}
+
+#if defined(__GLIBC__)
+
+/**
+ * @brief Asynchronous log writer.
+ *
+ * The log stream only copies its data into a bounded ring buffer, which a
+ * background thread drains into the file. When the buffer is full, the data
+ * are dropped (and counted) rather than blocking the writing thread.
+ * The stream lock serializes the producers, so the ring buffer only needs
+ * to synchronize a single producer with the single consumer.
+ */
+typedef struct LogWriter {
+	FILE *f;                                  /**< log file */
+	char *buffer;                             /**< ring buffer */
+	unsigned long long head;                  /**< number of bytes written into the buffer */
+	unsigned long long tail;                  /**< number of bytes drained from the buffer */
+	unsigned long long n_dropped;             /**< number of bytes dropped */
+	bool stop;                                /**< stop flag */
+	Thread thread;                            /**< writer thread */
+	FILE *log;                                /**< log stream */
+	struct LogWriter *next;                   /**< next opened log writer */
+} LogWriter;
+
+/** @brief Opened log writers, flushed at exit. */
+static struct {
+	LogWriter *first;                         /**< first opened log writer */
+	Lock lock;                                /**< lock on the list */
+	bool at_exit;                             /**< flush registered at exit */
+} log_writers = {NULL, PTHREAD_MUTEX_INITIALIZER, false};
+
+/**
+ * @brief Drain the ring buffer into the log file.
+ * @param v Log writer.
+ * @return NULL.
+ */
+static void* log_writer_loop(void *v)
+{
+	LogWriter *w = (LogWriter*) v;
+	unsigned long long head, tail = w->tail;
+	size_t i, n;
+	bool stop;
+
+	for (;;) {
+		stop = __atomic_load_n(&w->stop, __ATOMIC_ACQUIRE);
+		head = __atomic_load_n(&w->head, __ATOMIC_ACQUIRE);
+		if (head == tail) {
+			if (stop) break;
+			relax(LOG_WRITER_PERIOD);
+			continue;
+		}
+		while (tail < head) {
+			i = tail & (LOG_BUFFER_SIZE - 1);
+			n = MIN(head - tail, LOG_BUFFER_SIZE - i);
+			fwrite(w->buffer + i, 1, n, w->f);
+			tail += n;
+		}
+		fflush(w->f);
+		__atomic_store_n(&w->tail, tail, __ATOMIC_RELEASE);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Copy data from the log stream into the ring buffer.
+ * @param v Log writer.
+ * @param data Data to write.
+ * @param n Data size.
+ * @return Number of bytes consumed, always n.
+ */
+static ssize_t log_writer_write(void *v, const char *data, size_t n)
+{
+	LogWriter *w = (LogWriter*) v;
+	const unsigned long long head = w->head;
+	const unsigned long long tail = __atomic_load_n(&w->tail, __ATOMIC_ACQUIRE);
+	size_t i, m;
+
+	if (n > LOG_BUFFER_SIZE - (head - tail)) {
+		w->n_dropped += n;
+	} else {
+		i = head & (LOG_BUFFER_SIZE - 1);
+		m = MIN(n, LOG_BUFFER_SIZE - i);
+		memcpy(w->buffer + i, data, m);
+		memcpy(w->buffer, data + m, n - m);
+		__atomic_store_n(&w->head, head + n, __ATOMIC_RELEASE);
+	}
+
+	return n;
+}
+
+/**
+ * @brief Stop the writer thread, once the ring buffer is drained.
+ * @param w Log writer.
+ */
+static void log_writer_stop(LogWriter *w)
+{
+	if (!w->stop) {
+		__atomic_store_n(&w->stop, true, __ATOMIC_RELEASE);
+		thread_join(w->thread);
+		if (w->n_dropped) fprintf(w->f, "\n*** log: %llu bytes dropped ***\n", w->n_dropped);
+		fflush(w->f);
+	}
+}
+
+/**
+ * @brief Stop the writer thread & close the log file.
+ *
+ * Called by fclose() with the stream lock held, so the writer must already
+ * be unregistered by log_fclose(): log_flush_all() takes the stream lock
+ * with the list lock held.
+ * @param v Log writer.
+ * @return 0.
+ */
+static int log_writer_close(void *v)
+{
+	LogWriter *w = (LogWriter*) v;
+
+	log_writer_stop(w);
+	fclose(w->f);
+	free(w->buffer);
+	free(w);
+
+	return 0;
+}
+
+#endif
+
+/**
+ * @brief Write the pending data of the opened log files.
+ *
+ * Called at exit, and before an abort on a fatal error, so that the data
+ * still in the ring buffers are not lost. The log files are not usable
+ * anymore afterwards.
+ */
+void log_flush_all(void)
+{
+#if defined(__GLIBC__)
+	LogWriter *w;
+
+	lock(&log_writers);
+	for (w = log_writers.first; w; w = w->next) {
+		fflush(w->log);
+		log_writer_stop(w);
+	}
+	unlock(&log_writers);
+#endif
+}
+
+/**
+ * @brief Open a log file.
+ *
+ * Where available, the returned stream is asynchronous: writing into it,
+ * even with fflush(), never waits for the disk.
+ * @param file File name.
+ * @return a log stream, or NULL on failure.
+ */
+FILE* log_fopen(const char *file)
+{
+	FILE *f = fopen(file, "w");
+
+#if defined(__GLIBC__)
+	static const cookie_io_functions_t io = {NULL, log_writer_write, NULL, log_writer_close};
+	LogWriter *w;
+	FILE *log;
+
+	if (f == NULL) return NULL;
+
+	w = (LogWriter*) malloc(sizeof (LogWriter));
+	if (w == NULL) return f;
+	w->buffer = (char*) malloc(LOG_BUFFER_SIZE);
+	if (w->buffer == NULL) {
+		free(w);
+		return f;
+	}
+	w->f = f;
+	w->head = w->tail = w->n_dropped = 0;
+	w->stop = false;
+	log = fopencookie(w, "w", io);
+	if (log == NULL) {
+		free(w->buffer);
+		free(w);
+		return f;
+	}
+	w->log = log;
+	thread_create(&w->thread, log_writer_loop, w);
+
+	lock(&log_writers);
+	w->next = log_writers.first;
+	log_writers.first = w;
+	if (!log_writers.at_exit) log_writers.at_exit = (atexit(log_flush_all) == 0);
+	unlock(&log_writers);
+
+	f = log;
+#endif
+
+	return f;
+}
+
+/**
+ * @brief Close a log file.
+ *
+ * @param f Log stream, opened by log_fopen().
+ * @return 0 on success, EOF on failure (as fclose()).
+ */
+int log_fclose(FILE *f)
+{
+#if defined(__GLIBC__)
+	LogWriter **p;
+
+	lock(&log_writers);
+	for (p = &log_writers.first; *p; p = &(*p)->next) {
+		if ((*p)->log == f) {
+			*p = (*p)->next;
+			break;
+		}
+	}
+	unlock(&log_writers);
+#endif
+
+	return fclose(f);
+}
+
 /**
  * @brief Pseudo-random number generator.
  *
@@ -43,6 +43,7 @@ void print_scientific(double, const char*, FILE*);
  */
 char* string_duplicate(const char*);
 long long string_to_time(const char*);
+unsigned long long string_to_size(const char*);
 char* string_read_line(FILE*);
 char* string_copy_line(FILE*);
 void string_to_lowercase(char*);
@@ -234,6 +235,10 @@ typedef pthread_mutex_t SpinLock;
 /** boardcast a condition change */
 #define condition_broadcast(c) pthread_cond_broadcast(&(c)->cond)
 
+/** wait for a condition change, at most t ms */
+#define condition_timedwait(c, t) pthread_cond_timedwait_ms(&(c)->cond, &(c)->lock, t)
+void pthread_cond_timedwait_ms(pthread_cond_t*, pthread_mutex_t*, const int);
+
 /** free a condition */
 #define condition_free(c) pthread_cond_destroy(&(c)->cond)
 
@@ -281,6 +286,9 @@ typedef CONDITION_VARIABLE Condition;
 /** signal a condition change */
 #define condition_broadcast(c) WakeAllConditionVariable(&(c)->cond)
 
+/** wait for a condition change, at most t ms */
+#define condition_timedwait(c, t) SleepConditionVariableCS(&(c)->cond, &(c)->lock, t)
+
 /** free a condition */
 #define condition_free(c)
 
@@ -336,6 +344,30 @@ static inline void atomic_add(volatile unsigned long long *value, long long i)
 void cpu(void);
 int get_cpu_number(void);
 
+/** hardware performance counters */
+enum {
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	PERF_L1D_MISSES,
+	PERF_LLC_MISSES,
+	PERF_DTLB_MISSES,
+	PERF_BRANCH_MISSES,
+	PERF_N_COUNTERS
+};
+
+/** performance counters of a thread */
+typedef struct PerfCounters {
+	int fd[PERF_N_COUNTERS];                    /**< counter file descriptors (-1 if unavailable) */
+	unsigned long long start[PERF_N_COUNTERS];  /**< values at start */
+	unsigned long long count[PERF_N_COUNTERS];  /**< counts from start to stop */
+} PerfCounters;
+
+int perf_counters_open(PerfCounters*);
+void perf_counters_close(PerfCounters*);
+void perf_counters_start(PerfCounters*);
+void perf_counters_stop(PerfCounters*);
+void perf_counters_print(const PerfCounters*, const char*, const double, const char*, FILE*);
+
 /*
  * Error management
  */
@@ -350,6 +382,7 @@ int get_cpu_number(void);
 		if (errno) fprintf(stderr, "\terror #%d : %s", errno, strerror(errno)); \
 		fputc('\n', stderr); \
 		fprintf(stderr, __VA_ARGS__); \
+		log_flush_all(); \
 		abort(); \
 	} while (0)
 
@@ -423,16 +456,20 @@ typedef struct Log {
 	Lock lock;
 } Log;
 
+FILE* log_fopen(const char*);
+int log_fclose(FILE*);
+void log_flush_all(void);
+
 /** @brief open a log file if allowed. */
 #define log_open(l, file) if ((l)->f == NULL && file != NULL) { \
 	lock_init(l); \
-	(l)->f = fopen(file, "w"); \
+	(l)->f = log_fopen(file); \
 } else (void) 0
 
 /** @brief Close an opened log file. */
 #define log_close(l) if ((l)->f) { \
 	lock_free(l); \
-	fclose((l)->f); \
+	log_fclose((l)->f); \
 	(l)->f = NULL; \
 } else (void) 0
 
@@ -263,15 +263,6 @@ static void xboard_check_game_over(Play *play)
 	}
 }
 
-/**
- * Compute the hash tables size in MB
- */
-static inline int hash_size(int n)
-{
-	unsigned long long s = sizeof (Hash) << n;
-	return ((s << 1) + (s >> 4) + sizeof (HashTable) * 3) >> 20;
-}
-
 /**
  * Search for a move.
  *
@@ -697,11 +688,8 @@ void ui_loop_xboard(UI *ui)
 				xboard_error("(unknown command): %s %s", cmd, param);
 
 			} else if ((strcmp(cmd, "memory") == 0)) {
-				int size = string_to_int(param, 100);
-				
-				for (options.hash_table_size = 10; hash_size(options.hash_table_size + 1) < size; ++options.hash_table_size) ;
-				BOUND(options.hash_table_size, 10, 30, "hash-table-size");
-				log_print(xboard_log, "edax setup> hash table size: 2**%d entries\n", options.hash_table_size);
+				options.memory = (unsigned long long) string_to_int(param, 100) << 20;
+				log_print(xboard_log, "edax setup> memory budget: %llu MB\n", options.memory >> 20);
 				play_stop_pondering(play);
 				search_resize_hashtable(&play->search);
 			
@@ -459,8 +459,11 @@ void* task_loop(void *param)
 {
 	Task *task = (Task*) param;
 
+	if (options.perf_counters) perf_counters_open(&task->perf);
+
 	lock(task);
 	task->loop = true;
+	condition_signal(task); // the counters are opened
 
 	while (task->loop) {
 		if (!task->run) {
@@ -474,6 +477,8 @@ void* task_loop(void *param)
 
 	unlock(task);
 
+	perf_counters_close(&task->perf);
+
 	return NULL;
 }
 
@@ -524,6 +529,8 @@ static void task_search_destroy(Search *search)
  */
 void task_init(Task *task)
 {
+	int i;
+
 	lock_init(task);
 	condition_init(task);
 
@@ -533,6 +540,7 @@ void task_init(Task *task)
 	task->move = NULL;
 	task->n_calls = 0;
 	task->n_nodes = 0;
+	for (i = 0; i < PERF_N_COUNTERS; ++i) task->perf.fd[i] = -1;
 	task->search = task_search_create(task);
 }
 
@@ -588,6 +596,10 @@ void task_stack_init(TaskStack *stack, const int n)
 				task_init(stack->task + i);
 				thread_create(&stack->task[i].thread, task_loop, stack->task + i);
 				if (options.cpu_affinity) thread_set_cpu(stack->task[i].thread, i); /* CPU 0 to n - 1 */
+				// wait for the task loop, so that its performance counters are opened.
+				lock(stack->task + i);
+				while (!stack->task[i].loop) condition_wait(stack->task + i);
+				unlock(stack->task + i);
 			}
 			stack->task[i].container = stack;
 			stack->stack[i] = NULL;
@@ -36,6 +36,7 @@ typedef struct Task {
 	Thread thread;               /**< thread */
 	unsigned long long n_calls;  /**< call counter */
 	unsigned long long n_nodes;  /**< nodes counter */
+	PerfCounters perf;           /**< performance counters of the thread */
 	Lock lock;                   /**< lock */
 	Condition cond;              /**< condition */
 	struct TaskStack *container; /**< link to its container */